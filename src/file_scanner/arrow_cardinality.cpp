@@ -0,0 +1,150 @@
+#include "file_scanner/arrow_cardinality.hpp"
+
+#include "file_scanner/arrow_file_scan.hpp"
+#include "file_scanner/arrow_multi_file_info.hpp"
+#include "ipc/stream_reader/ipc_file_stream_reader.hpp"
+
+#include "duckdb/storage/buffer_manager.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+void ArrowCardinality::CountFiles(ClientContext& context, MultiFileList& files,
+                                  ArrowMultiFileData& data,
+                                  optional_ptr<ArrowFileScan> initial_reader) {
+  auto file_count = files.GetTotalFileCount();
+  if (file_count == 0) {
+    return;
+  }
+
+  // For large globs, count an evenly spaced sample of the files
+  idx_t sample_count = MinValue<idx_t>(file_count, MAX_COUNTED_FILES);
+  idx_t row_count = 0;
+  bool exact = true;
+  for (idx_t i = 0; i < sample_count; i++) {
+    auto file = files.GetFile(i * file_count / sample_count);
+    idx_t file_row_count;
+    bool file_exact;
+    if (initial_reader && initial_reader->GetFileName() == file.path &&
+        CountRows(*initial_reader, file_row_count, file_exact)) {
+      row_count += file_row_count;
+      exact = exact && file_exact;
+      continue;
+    }
+    auto file_rows = CountRows(context, file.path);
+    if (!file_rows) {
+      return;
+    }
+    row_count += file_rows->row_count;
+    exact = exact && file_rows->exact;
+  }
+
+  data.counted_files = sample_count;
+  data.counted_rows = row_count;
+  data.counted_rows_exact = exact;
+}
+
+shared_ptr<ArrowFileRowCount> ArrowCardinality::CountRows(ClientContext& context,
+                                                          const string& path) {
+  auto& fs = FileSystem::GetFileSystem(context);
+  auto& cache = ObjectCache::GetObjectCache(context);
+  auto key = ArrowFileRowCount::ObjectType() + ":" + path;
+  try {
+    auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+    if (!handle->CanSeek() || handle->IsPipe()) {
+      // Reading a pipe here would take the data away from the scan
+      return nullptr;
+    }
+    auto last_modified = static_cast<int64_t>(fs.GetLastModifiedTime(*handle));
+    auto file_size = static_cast<idx_t>(handle->GetFileSize());
+
+    auto cached = cache.Get<ArrowFileRowCount>(key);
+    if (cached && cached->last_modified == last_modified &&
+        cached->file_size == file_size) {
+      return cached;
+    }
+
+    IPCFileStreamReader reader(std::move(handle), BufferAllocator::Get(context),
+                               /*direct_io*/ false, READ_AHEAD_SIZE);
+    idx_t row_count;
+    bool exact = true;
+    // Files with batch statistics know their row count without reading headers
+    auto statistics = reader.ReadStatistics();
+    if (statistics) {
+      row_count = statistics->RowCount();
+    } else if (!reader.CountRows(MAX_COUNTED_BATCHES, row_count, exact)) {
+      return nullptr;
+    }
+    auto result =
+        make_shared_ptr<ArrowFileRowCount>(last_modified, file_size, row_count, exact);
+    cache.Put(key, result);
+    return result;
+  } catch (std::exception&) {
+    // An estimate is not worth failing the query over, the scan will report any
+    // problem with the file
+    return nullptr;
+  }
+}
+
+bool ArrowCardinality::CountRows(ArrowFileScan& file_scan, idx_t& row_count,
+                                 bool& exact) {
+  if (file_scan.batch_statistics) {
+    row_count = file_scan.batch_statistics->RowCount();
+    exact = true;
+    return true;
+  }
+  if (!file_scan.factory || !file_scan.factory->reader) {
+    return false;
+  }
+  // The footer and the first header were read to open the file. Streams would have
+  // their headers decoded, which the scan of this reader can't have.
+  auto& reader = static_cast<IPCFileStreamReader&>(*file_scan.factory->reader);
+  try {
+    return reader.CountFooterRows(row_count, exact);
+  } catch (std::exception&) {
+    return false;
+  }
+}
+
+shared_ptr<ArrowFileColumnStatistics> ArrowCardinality::ReadColumnStatistics(
+    ClientContext& context, const string& path) {
+  auto& fs = FileSystem::GetFileSystem(context);
+  auto& cache = ObjectCache::GetObjectCache(context);
+  auto key = ArrowFileColumnStatistics::ObjectType() + ":" + path;
+  try {
+    auto handle = fs.OpenFile(path, FileOpenFlags::FILE_FLAGS_READ);
+    if (!handle->CanSeek() || handle->IsPipe()) {
+      return nullptr;
+    }
+    auto last_modified = static_cast<int64_t>(fs.GetLastModifiedTime(*handle));
+    auto file_size = static_cast<idx_t>(handle->GetFileSize());
+
+    auto cached = cache.Get<ArrowFileColumnStatistics>(key);
+    if (cached && cached->last_modified == last_modified &&
+        cached->file_size == file_size) {
+      return cached;
+    }
+
+    IPCFileStreamReader reader(std::move(handle), BufferAllocator::Get(context),
+                               /*direct_io*/ false, READ_AHEAD_SIZE);
+    auto result = make_shared_ptr<ArrowFileColumnStatistics>(last_modified, file_size);
+    auto statistics = reader.ReadStatistics();
+    if (statistics) {
+      reader.PopulateNames(result->names);
+      result->has_statistics = true;
+      result->types = statistics->types;
+      result->row_count = statistics->RowCount();
+      for (idx_t i = 0; i < statistics->types.size(); i++) {
+        result->columns.push_back(statistics->ColumnStatistics(i));
+      }
+    }
+    cache.Put(key, result);
+    return result;
+  } catch (std::exception&) {
+    // The scan will report any problem with the file
+    return nullptr;
+  }
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,164 @@
+#include "file_scanner/arrow_file_prefetcher.hpp"
+
+#include "duckdb/parallel/task.hpp"
+
+#include "file_scanner/arrow_file_scan.hpp"
+#include "file_scanner/arrow_multi_file_info.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+class ArrowPrefetchTask : public Task {
+ public:
+  ArrowPrefetchTask(ArrowFilePrefetcher& prefetcher, shared_ptr<ArrowPrefetchedFile> file,
+                    string path)
+      : prefetcher(prefetcher), file(std::move(file)), path(std::move(path)) {}
+
+  TaskExecutionResult Execute(TaskExecutionMode mode) override {
+    {
+      lock_guard<mutex> guard(file->lock);
+      if (file->state != ArrowPrefetchedFile::State::QUEUED) {
+        // Cancelled, or the scan opened the file itself: the prefetcher may be gone
+        return TaskExecutionResult::TASK_FINISHED;
+      }
+      file->state = ArrowPrefetchedFile::State::OPENING;
+    }
+    // The prefetcher waits for OPENING files before it is destroyed, so it (and the
+    // context of the query) are valid until the file is OPENED
+    shared_ptr<ArrowFileScan> file_scan;
+    ErrorData error;
+    try {
+      if (!prefetcher.Cancelled()) {
+        file_scan = make_shared_ptr<ArrowFileScan>(prefetcher.gstate.context, path,
+                                                   prefetcher.options,
+                                                   &prefetcher.gstate.schema_cache);
+      }
+      if (file_scan && !prefetcher.Cancelled()) {
+        file_scan->Prefetch();
+      }
+    } catch (std::exception& ex) {
+      file_scan.reset();
+      error = ErrorData(ex);
+    }
+    lock_guard<mutex> guard(file->lock);
+    file->file_scan = std::move(file_scan);
+    file->error = std::move(error);
+    file->state = ArrowPrefetchedFile::State::OPENED;
+    file->opened.notify_all();
+    return TaskExecutionResult::TASK_FINISHED;
+  }
+
+ private:
+  ArrowFilePrefetcher& prefetcher;
+  shared_ptr<ArrowPrefetchedFile> file;
+  string path;
+};
+
+}  // namespace
+
+ArrowFilePrefetcher::ArrowFilePrefetcher(MultiFileList& files, idx_t file_count,
+                                         const ArrowFileReaderOptions& options,
+                                         ArrowFileGlobalState& gstate, idx_t depth)
+    : files(files),
+      file_count(file_count),
+      options(options),
+      gstate(gstate),
+      depth(depth),
+      token(TaskScheduler::GetScheduler(gstate.context).CreateProducer()) {}
+
+ArrowFilePrefetcher::~ArrowFilePrefetcher() {
+  Cancel();
+  // Files that a task is opening still use the context and the schema cache
+  for (auto& entry : pending) {
+    auto& file = *entry.second;
+    unique_lock<mutex> guard(file.lock);
+    file.opened.wait(
+        guard, [&]() { return file.state != ArrowPrefetchedFile::State::OPENING; });
+  }
+}
+
+idx_t ArrowFilePrefetcher::GetDepth(ClientContext& context) {
+  Value setting;
+  if (!context.TryGetCurrentSetting("arrow_prefetch_files", setting) ||
+      setting.IsNull()) {
+    return 0;
+  }
+  // With a single thread, no thread would be free to open files ahead
+  if (TaskScheduler::GetScheduler(context).NumberOfThreads() <= 1) {
+    return 0;
+  }
+  return setting.GetValue<idx_t>();
+}
+
+bool ArrowFilePrefetcher::Cancelled() const {
+  return cancelled.load() || gstate.context.interrupted || gstate.LimitReached();
+}
+
+void ArrowFilePrefetcher::Cancel() {
+  cancelled = true;
+  lock_guard<mutex> guard(lock);
+  for (auto& entry : pending) {
+    auto& file = *entry.second;
+    lock_guard<mutex> file_guard(file.lock);
+    if (file.state == ArrowPrefetchedFile::State::QUEUED) {
+      file.state = ArrowPrefetchedFile::State::CANCELLED;
+    }
+  }
+}
+
+shared_ptr<ArrowFileScan> ArrowFilePrefetcher::Take(idx_t file_idx) {
+  shared_ptr<ArrowPrefetchedFile> file;
+  {
+    lock_guard<mutex> guard(lock);
+    // The scan thread opens the file itself if it wasn't prefetched yet
+    next_file = MaxValue<idx_t>(next_file, file_idx + 1);
+    auto entry = pending.find(file_idx);
+    if (entry == pending.end()) {
+      return nullptr;
+    }
+    file = std::move(entry->second);
+    pending.erase(entry);
+  }
+
+  unique_lock<mutex> guard(file->lock);
+  if (file->state != ArrowPrefetchedFile::State::OPENING &&
+      file->state != ArrowPrefetchedFile::State::OPENED) {
+    // No thread was free to open it: the scan thread opens it without waiting
+    file->state = ArrowPrefetchedFile::State::CANCELLED;
+    return nullptr;
+  }
+  file->opened.wait(
+      guard, [&]() { return file->state == ArrowPrefetchedFile::State::OPENED; });
+  if (file->error.HasError()) {
+    file->error.Throw();
+  }
+  if (file->file_scan) {
+    prefetched_files++;
+  }
+  return std::move(file->file_scan);
+}
+
+void ArrowFilePrefetcher::Schedule(idx_t file_idx) {
+  if (Cancelled()) {
+    return;
+  }
+  auto& scheduler = TaskScheduler::GetScheduler(gstate.context);
+  lock_guard<mutex> guard(lock);
+  next_file = MaxValue<idx_t>(next_file, file_idx + 1);
+  while (next_file <= file_idx + depth && next_file < file_count) {
+    auto path = files.GetFile(next_file).path;
+    if (path.empty()) {
+      break;
+    }
+    auto file = make_shared_ptr<ArrowPrefetchedFile>();
+    pending[next_file] = file;
+    scheduler.ScheduleTask(*token,
+                           make_shared_ptr<ArrowPrefetchTask>(*this, file, path));
+    next_file++;
+  }
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
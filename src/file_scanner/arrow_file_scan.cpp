@@ -1,29 +1,473 @@
 #include "file_scanner/arrow_file_scan.hpp"
 
+#include <algorithm>
+
 #include "file_scanner/arrow_multi_file_info.hpp"
+#include "ipc/stream_reader/ipc_file_stream_reader.hpp"
+
+#include "duckdb/common/types/hash.hpp"
+#include "duckdb/execution/expression_executor.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/in_filter.hpp"
+#include "duckdb/planner/filter/optional_filter.hpp"
+#include "duckdb/planner/table_filter.hpp"
+#include "duckdb/storage/storage_info.hpp"
+#include "ipc/bloom_filter.hpp"
 
 namespace duckdb {
 namespace ext_nanoarrow {
 struct ArrowFileLocalState;
 
-ArrowFileScan::ArrowFileScan(ClientContext& context, const string& file_name)
-    : BaseFileReader(file_name) {
-  factory = make_uniq<FileIPCStreamFactory>(context, file_name);
+namespace {
+
+template <typename T>
+bool RowsInSingleRun(const ArrowArray& run_ends, int64_t start, int64_t end) {
+  auto values = static_cast<const T*>(run_ends.buffers[1]) + run_ends.offset;
+  auto values_end = values + run_ends.length;
+  // The run holding a logical row is the first one that ends after it
+  auto run = std::upper_bound(values, values_end, static_cast<T>(start));
+  return run != values_end && static_cast<int64_t>(*run) >= end;
+}
+
+//! Checks if rows [start, end) of a run-end encoded array are all part of a
+//! single run (i.e., they all have the same value)
+bool RowsInSingleRun(const ArrowArray& array, const string& run_ends_format,
+                     int64_t start, int64_t end) {
+  D_ASSERT(array.n_children == 2);
+  const ArrowArray& run_ends = *array.children[0];
+  start += array.offset;
+  end += array.offset;
+  if (run_ends_format == "s") {
+    return RowsInSingleRun<int16_t>(run_ends, start, end);
+  } else if (run_ends_format == "i") {
+    return RowsInSingleRun<int32_t>(run_ends, start, end);
+  } else if (run_ends_format == "l") {
+    return RowsInSingleRun<int64_t>(run_ends, start, end);
+  }
+  return false;
+}
+
+//! Returns true if the bloom filter of a column shows that none of its values pass
+//! an equality or IN filter
+bool BloomFilterExcludes(const TableFilter& filter, const string& bloom_filter,
+                         const LogicalType& type) {
+  switch (filter.filter_type) {
+    case TableFilterType::CONSTANT_COMPARISON: {
+      auto& constant_filter = filter.Cast<ConstantFilter>();
+      return constant_filter.comparison_type == ExpressionType::COMPARE_EQUAL &&
+             constant_filter.constant.type() == type &&
+             !ArrowBloomFilter::MayContain(bloom_filter, constant_filter.constant);
+    }
+    case TableFilterType::IN_FILTER: {
+      for (const auto& value : filter.Cast<InFilter>().values) {
+        if (value.type() != type || ArrowBloomFilter::MayContain(bloom_filter, value)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case TableFilterType::CONJUNCTION_AND: {
+      for (const auto& child : filter.Cast<ConjunctionAndFilter>().child_filters) {
+        if (BloomFilterExcludes(*child, bloom_filter, type)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case TableFilterType::OPTIONAL_FILTER: {
+      // Implied by the other filters, so it can rule out batches too
+      auto& child = filter.Cast<OptionalFilter>().child_filter;
+      return child && BloomFilterExcludes(*child, bloom_filter, type);
+    }
+    default:
+      return false;
+  }
+}
+
+//! Skips the record batches whose statistics (min/max and bloom filters) show that
+//! none of their rows pass the pushed down filters. Dynamic filters (e.g., the
+//! boundary of a Top-N, which tightens as the query runs) are checked with their
+//! value at the start of each batch.
+class StatisticsBatchFilter : public RecordBatchFilter {
+ public:
+  StatisticsBatchFilter(shared_ptr<ArrowFileStatistics> statistics,
+                        const TableFilterSet& filters,
+                        const vector<ColumnIndex>& column_indexes)
+      : statistics(std::move(statistics)), filters(filters) {
+    for (const auto& column_index : column_indexes) {
+      column_ids.push_back(column_index.GetPrimaryIndex());
+    }
+  }
+
+  bool SkipBatch(idx_t batch_index, optional_idx message_offset,
+                 const IPCRecordBatchHeader* header) override {
+    if (!message_offset.IsValid()) {
+      return false;
+    }
+    auto batch = statistics->FindBatch(message_offset.GetIndex());
+    if (!batch) {
+      return false;
+    }
+    for (const auto& entry : filters.filters) {
+      if (entry.first >= column_ids.size() ||
+          column_ids[entry.first] >= batch->columns.size()) {
+        // Virtual columns have no statistics
+        continue;
+      }
+      auto column_id = column_ids[entry.first];
+      if (entry.second->CheckStatistics(batch->columns[column_id]) ==
+          FilterPropagateResult::FILTER_ALWAYS_FALSE) {
+        return true;
+      }
+      const auto& bloom_filter = batch->bloom_filters[column_id];
+      if (!bloom_filter.empty() &&
+          BloomFilterExcludes(*entry.second, bloom_filter,
+                              statistics->types[column_id])) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  shared_ptr<ArrowFileStatistics> statistics;
+  const TableFilterSet& filters;
+  //! Column of the file of each scanned column
+  vector<idx_t> column_ids;
+};
+
+//! The Arrow scan expands run-end encoded columns into flat vectors. When every
+//! row of a chunk comes from the same run we hand DuckDB a constant vector
+//! instead, which downstream operators can process once per chunk.
+void EmitConstantRuns(ArrowFileLocalState& lstate, DataChunk& chunk) {
+  if (lstate.run_end_encoded_columns.empty()) {
+    return;
+  }
+  auto& arrow_state = lstate.local_arrow_local_state->Cast<ArrowScanLocalState>();
+  if (!arrow_state.chunk) {
+    return;
+  }
+  const ArrowArray& batch = arrow_state.chunk->arrow_array;
+  auto end = static_cast<int64_t>(arrow_state.chunk_offset) + batch.offset;
+  auto start = end - static_cast<int64_t>(chunk.size());
+  for (const auto& column : lstate.run_end_encoded_columns) {
+    if (column.array_idx >= static_cast<idx_t>(batch.n_children)) {
+      continue;
+    }
+    if (RowsInSingleRun(*batch.children[column.array_idx], column.run_ends_format,
+                        start, end)) {
+      chunk.data[column.output_idx].SetVectorType(VectorType::CONSTANT_VECTOR);
+    }
+  }
+}
+
+//! Adds the dynamic filters of a filter with their current value
+void CollectDynamicFilters(const TableFilter& filter,
+                           vector<ArrowRowFilter::DynamicFilterValue>& result) {
+  switch (filter.filter_type) {
+    case TableFilterType::DYNAMIC_FILTER: {
+      auto& dynamic_filter = filter.Cast<DynamicFilter>();
+      if (!dynamic_filter.filter_data) {
+        return;
+      }
+      ArrowRowFilter::DynamicFilterValue value;
+      value.data = dynamic_filter.filter_data;
+      lock_guard<mutex> guard(value.data->lock);
+      value.initialized = value.data->initialized;
+      if (value.initialized && value.data->filter) {
+        value.constant = value.data->filter->constant;
+      }
+      result.push_back(std::move(value));
+      return;
+    }
+    case TableFilterType::CONJUNCTION_AND:
+    case TableFilterType::CONJUNCTION_OR:
+      for (const auto& child : filter.Cast<ConjunctionFilter>().child_filters) {
+        CollectDynamicFilters(*child, result);
+      }
+      return;
+    default:
+      return;
+  }
+}
+
+//! Checks if a dynamic filter changed its value since it was collected
+bool DynamicFiltersChanged(const vector<ArrowRowFilter::DynamicFilterValue>& values) {
+  for (const auto& value : values) {
+    lock_guard<mutex> guard(value.data->lock);
+    if (value.data->initialized != value.initialized) {
+      return true;
+    }
+    if (value.initialized && value.data->filter &&
+        value.data->filter->constant != value.constant) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//! Skips (and never converts) the vectors of the record batches in which no value
+//! passes one of the prefilters. Batches are loaded here rather than by the Arrow
+//! scan, which converts the first vector of a batch right after loading it, so that
+//! every vector of every batch is checked. Returns false if the scan is done.
+bool SkipPrefilteredRows(ClientContext& context, ArrowFileGlobalState& gstate,
+                         ArrowFileLocalState& lstate) {
+  if (lstate.prefilters.empty()) {
+    return true;
+  }
+  auto& arrow_state = lstate.local_arrow_local_state->Cast<ArrowScanLocalState>();
+  auto& arrow_gstate = lstate.local_arrow_global_state->Cast<ArrowScanGlobalState>();
+  while (arrow_state.chunk) {
+    const ArrowArray& batch = arrow_state.chunk->arrow_array;
+    if (arrow_state.chunk_offset >= static_cast<idx_t>(batch.length)) {
+      if (!ArrowTableFunction::ArrowScanParallelStateNext(
+              context, lstate.table_function_input->bind_data.get(), arrow_state,
+              arrow_gstate)) {
+        return false;
+      }
+      continue;
+    }
+    auto start = static_cast<int64_t>(arrow_state.chunk_offset);
+    auto end = MinValue<int64_t>(start + STANDARD_VECTOR_SIZE, batch.length);
+    bool may_match = true;
+    for (const auto& prefilter : lstate.prefilters) {
+      if (prefilter->array_idx >= static_cast<idx_t>(batch.n_children)) {
+        return true;
+      }
+      if (!prefilter->MayMatch(*batch.children[prefilter->array_idx],
+                               start + batch.offset, end + batch.offset)) {
+        may_match = false;
+        break;
+      }
+    }
+    if (may_match) {
+      return true;
+    }
+    auto skipped = static_cast<idx_t>(end - start);
+    arrow_state.chunk_offset += skipped;
+    // Keeps the row numbers of the rows that are converted right
+    lstate.local_arrow_function_data->lines_read += skipped;
+    gstate.prefiltered_rows += skipped;
+  }
+  return true;
+}
+
+}  // namespace
+
+ArrowFileScan::ArrowFileScan(ClientContext& context, const string& file_name,
+                             const ArrowFileReaderOptions& options,
+                             optional_ptr<ArrowFileSchemaCache> schema_cache)
+    : BaseFileReader(file_name), options(options) {
+  factory = make_uniq<FileIPCStreamFactory>(context, file_name, options.direct_io);
 
   factory->InitReader();
   factory->GetFileSchema(schema_root);
-  DBConfig& config = DatabaseInstance::GetDatabase(context).config;
-  ArrowTableFunction::PopulateArrowTableType(config, arrow_table_type, schema_root, names,
-                                             types);
-  QueryResult::DeduplicateColumns(names);
-  if (types.empty()) {
-    throw InvalidInputException("Provided table/dataframe must have at least one column");
+  if (schema_cache) {
+    file_schema = schema_cache->Get(factory->reader->GetSchemaMessage());
+  }
+  if (!file_schema) {
+    auto converted = make_shared_ptr<ArrowFileSchema>();
+    DBConfig& config = DatabaseInstance::GetDatabase(context).config;
+    // Columns with a conversion kernel are converted before the Arrow scan sees
+    // them, so their Arrow types are those of the converted columns. The readers
+    // keep decoding with the schema of the file.
+    ArrowSchemaWrapper scan_schema;
+    NANOARROW_THROW_NOT_OK(
+        ArrowSchemaDeepCopy(&schema_root.arrow_schema, &scan_schema.arrow_schema));
+    ArrowConversionKernel::ConvertSchema(scan_schema.arrow_schema);
+    ArrowTableFunction::PopulateArrowTableType(config, converted->arrow_table_type,
+                                               scan_schema, converted->names,
+                                               converted->types);
+    QueryResult::DeduplicateColumns(converted->names);
+    if (converted->types.empty()) {
+      throw InvalidInputException(
+          "Provided table/dataframe must have at least one column");
+    }
+    converted->schema_index = factory->reader->GetSharedSchemaIndex();
+    file_schema = schema_cache ? schema_cache->Insert(
+                                     factory->reader->GetSchemaMessage(), converted)
+                               : converted;
   }
+  factory->reader->SetSchemaIndex(file_schema->schema_index);
+  arrow_table_type = file_schema->arrow_table_type;
+  names = file_schema->names;
+  types = file_schema->types;
   columns = MultiFileColumnDefinition::ColumnsFromNamesAndTypes(names, types);
+  // Costs one small read at the end of the file, like the footer of IPC files
+  auto statistics = static_cast<IPCFileStreamReader&>(*factory->reader).ReadStatistics();
+  if (statistics && statistics->types == types) {
+    batch_statistics = std::move(statistics);
+  }
+  InitializeScanUnits(context);
+}
+
+ArrowFileScan::ArrowFileScan(const string& file_name,
+                             const vector<MultiFileColumnDefinition>& expected_columns)
+    : BaseFileReader(file_name) {
+  columns = expected_columns;
+  for (const auto& column : columns) {
+    names.push_back(column.name);
+    types.push_back(column.type);
+  }
 }
 
 string ArrowFileScan::GetReaderType() const { return "ARROW"; }
 
+void ArrowFileScan::Prefetch() {
+  if (factory && factory->reader) {
+    static_cast<IPCFileStreamReader&>(*factory->reader).Prefetch();
+  }
+}
+
+void ArrowFileScan::InitializeScanUnits(ClientContext& context) {
+  vector<IPCFileBlock> blocks;
+  auto& file_reader = static_cast<IPCFileStreamReader&>(*factory->reader);
+  if (!file_reader.ReadFooterBlocks(blocks) || blocks.size() < 2) {
+    return;
+  }
+  auto min_unit_size =
+      options.bulk_load ? BulkLoadScanUnitSize(blocks) : MIN_SCAN_UNIT_SIZE;
+
+  // Record batches are split into ranges of consecutive messages, so that a file
+  // with many small batches isn't opened once per batch
+  idx_t previous_end = 8;
+  for (const auto& block : blocks) {
+    if (block.offset < static_cast<int64_t>(previous_end) || block.offset % 8 != 0 ||
+        block.metadata_length <= 0 || block.body_length < 0) {
+      // Blocks that are out of order or overlap: don't split the file
+      scan_units.clear();
+      return;
+    }
+    auto start = static_cast<idx_t>(block.offset);
+    auto end = start + static_cast<idx_t>(block.metadata_length) +
+               static_cast<idx_t>(block.body_length);
+    if (scan_units.empty() ||
+        scan_units.back().end - scan_units.back().start >= min_unit_size) {
+      scan_units.push_back({start, end});
+    } else {
+      scan_units.back().end = end;
+    }
+    previous_end = end;
+  }
+  if (scan_units.size() < 2) {
+    scan_units.clear();
+  }
+}
+
+idx_t ArrowFileScan::BulkLoadScanUnitSize(const vector<IPCFileBlock>& blocks) {
+  // The insert of COPY ... FROM writes (and compresses) the row groups of a scan unit
+  // in the thread that scanned it once the unit is done. Smaller units are merged
+  // into row groups afterwards, which appends their rows a second time.
+  auto block_size = [](const IPCFileBlock& block) {
+    return static_cast<idx_t>(MaxValue<int64_t>(block.metadata_length, 0)) +
+           static_cast<idx_t>(MaxValue<int64_t>(block.body_length, 0));
+  };
+  idx_t message_size = 0;
+  for (const auto& block : blocks) {
+    message_size += block_size(block);
+  }
+  // The rows per byte come from the batch statistics or else from the header of the
+  // first record batch, which the scan of the first unit reads next anyway
+  idx_t row_count = 0;
+  idx_t counted_size = message_size;
+  if (batch_statistics) {
+    row_count = batch_statistics->RowCount();
+  } else {
+    auto& file_reader = static_cast<IPCFileStreamReader&>(*factory->reader);
+    counted_size = block_size(blocks[0]);
+    if (!file_reader.ReadBlockRowCount(blocks[0], row_count)) {
+      return MIN_SCAN_UNIT_SIZE;
+    }
+  }
+  if (row_count == 0 || counted_size == 0) {
+    return MIN_SCAN_UNIT_SIZE;
+  }
+  auto row_size = static_cast<double>(counted_size) / static_cast<double>(row_count);
+  auto unit_size =
+      static_cast<idx_t>(row_size * static_cast<double>(DEFAULT_ROW_GROUP_SIZE));
+  return MaxValue<idx_t>(unit_size, MIN_SCAN_UNIT_SIZE);
+}
+
+void ArrowFileScan::RegisterSharedScan(ClientContext& context) {
+  if (shared_scan_checked) {
+    return;
+  }
+  // Only scans register, files that are just opened (e.g., to bind) don't
+  shared_scan_checked = true;
+  auto& file_reader = static_cast<IPCFileStreamReader&>(*factory->reader);
+  if (!file_reader.IsSeekable()) {
+    // Pipes and other sources that can't seek give different data every time
+    return;
+  }
+  bool batch_cache = ArrowBatchCache::Get(context) != nullptr;
+  auto window_budget = ArrowSharedScans::WindowBudget(context);
+  if (!batch_cache && window_budget == 0) {
+    return;
+  }
+  cache_file = make_uniq<ArrowBatchCacheFile>(file_reader.GetCacheFile());
+  if (batch_cache && !cache_file->recently_modified) {
+    // The batch cache shares the batches with the concurrent scans as well
+    return;
+  }
+  if (window_budget > 0) {
+    shared_scan = ArrowSharedScans::Register(context, *cache_file, window_budget);
+  }
+}
+
+FileIPCStreamFactory* ArrowFileScan::NextScanFactory(ClientContext& context,
+                                                     ArrowFileGlobalState& gstate,
+                                                     ArrowFileLocalState& lstate,
+                                                     idx_t& unit_idx) {
+  if (scan_units.empty()) {
+    // This file is scanned as a whole by a single thread
+    unit_idx = 0;
+    if (gstate.files.find(file_list_idx.GetIndex()) != gstate.files.end()) {
+      return nullptr;
+    }
+    gstate.files.insert(file_list_idx.GetIndex());
+    return factory.get();
+  }
+  if (next_scan_unit >= scan_units.size()) {
+    return nullptr;
+  }
+
+  if (next_scan_unit == 0 && shared_scan &&
+      !DBConfig::GetConfig(context).options.preserve_insertion_order) {
+    // Start where the other scans of the file are reading now, and wrap around
+    // for the units they read before this scan started
+    auto latest_unit = shared_scan->Get().LatestUnit();
+    for (idx_t i = 0; latest_unit.IsValid() && i < scan_units.size(); i++) {
+      if (scan_units[i].start == latest_unit.GetIndex()) {
+        first_scan_unit = i;
+        break;
+      }
+    }
+  }
+  // Otherwise scan units are handed out in file order, which gives them increasing
+  // batch indexes and lets order preserving sinks put the chunks back in file order
+  unit_idx = (first_scan_unit + next_scan_unit++) % scan_units.size();
+  if (shared_scan) {
+    shared_scan->Get().StartUnit(scan_units[unit_idx].start);
+  }
+  FileIPCStreamFactory* unit_factory = factory.get();
+  if (unit_idx > 0) {
+    // The other units are read through their own file handle
+    lstate.unit_factory =
+        make_uniq<FileIPCStreamFactory>(context, GetFileName(), options.direct_io);
+    lstate.unit_factory->InitReader();
+    lstate.unit_factory->reader->SetBaseSchema(&schema_root.arrow_schema);
+    lstate.unit_factory->reader->SetSchemaIndex(file_schema->schema_index);
+    unit_factory = lstate.unit_factory.get();
+  }
+  auto& unit = scan_units[unit_idx];
+  static_cast<IPCFileStreamReader&>(*unit_factory->reader)
+      .SetReadRange(unit.start, unit.end);
+  return unit_factory;
+}
+
 const vector<string>& ArrowFileScan::GetNames() { return names; }
 const vector<LogicalType>& ArrowFileScan::GetTypes() { return types; }
 
@@ -32,19 +476,82 @@ bool ArrowFileScan::TryInitializeScan(ClientContext& context,
                                       LocalTableFunctionState& lstate_p) {
   auto& gstate = gstate_p.Cast<ArrowFileGlobalState>();
   auto& lstate = lstate_p.Cast<ArrowFileLocalState>();
-  if (gstate.files.find(file_list_idx.GetIndex()) != gstate.files.end()) {
-    // Return false because we don't currently support more than one thread
-    // scanning a file. In the future we may be able to support this by (e.g.)
-    // reading the Arrow file footer or sending a thread to read ahead to scan
-    // for RecordBatch messages.
+  if (!factory || gstate.LimitReached()) {
+    // There is nothing left that this query needs from this file
     return false;
   }
-  gstate.files.insert(file_list_idx.GetIndex());
+  // Streams are scanned by a single thread. IPC files with more than one record
+  // batch are split into scan units through their footer.
+  RegisterSharedScan(context);
+  idx_t unit_idx;
+  auto scan_factory = NextScanFactory(context, gstate, lstate, unit_idx);
+  if (!scan_factory) {
+    return false;
+  }
+  // The arrow table type of the file is that of the converted columns
+  scan_factory->reader->EnableConversionKernels();
+  static_cast<IPCFileStreamReader&>(*scan_factory->reader)
+      .SetSlicedBodySize(gstate.sliced_body_size, gstate.sliced_batches);
+  shared_ptr<ArrowBatchCache> batch_cache;
+  if (cache_file && !cache_file->recently_modified) {
+    batch_cache = ArrowBatchCache::Get(context);
+  }
+  if (batch_cache) {
+    scan_factory->reader->SetBatchCache(std::move(batch_cache), *cache_file,
+                                        gstate.cached_batches);
+  } else if (shared_scan) {
+    // Batches decoded by the concurrent scans of the file are used, not decoded again
+    scan_factory->reader->SetBatchCache(shared_scan->Get().window, *cache_file,
+                                        gstate.cached_batches);
+  }
+
+  if (gstate.sample_percentage < 100) {
+    // Pushed down sample: skip (and never read) the bodies of unsampled batches
+    int64_t seed = -1;
+    if (gstate.sample_seed.IsValid()) {
+      // Every scan unit of every file gets its own random stream (a sum of the
+      // indexes would give file 0, unit 1 the stream of file 1, unit 0)
+      auto file_hash = CombineHash(Hash<idx_t>(gstate.sample_seed.GetIndex()),
+                                   Hash<idx_t>(file_list_idx.GetIndex()));
+      seed = static_cast<int64_t>(file_hash ^ unit_idx);
+    }
+    scan_factory->reader->AddBatchFilter(
+        make_uniq<SampleBatchFilter>(gstate.sample_percentage, seed));
+  }
+  if (gstate.limit.IsValid()) {
+    // This file (or part of it) may have to provide all of the rows by itself
+    scan_factory->reader->SetRowLimit(gstate.limit.GetIndex());
+  }
+  if (filters && batch_statistics) {
+    // Record batches that can't have matching rows are skipped without reading
+    // their body
+    scan_factory->reader->AddBatchFilter(make_uniq<StatisticsBatchFilter>(
+        batch_statistics, *filters,
+        column_indexes.empty() ? gstate.global_state.column_indexes : column_indexes));
+  }
+
+  if (lstate.table_function_input && lstate.scan_schema == file_schema && !filters) {
+    // The previous file of this thread had the same schema (and thus the same
+    // column mapping): keep the arrow scan state and only swap in the new stream.
+    // This keeps the per-file cost of scanning many small files low.
+    lstate.local_arrow_function_data->stream_factory_ptr =
+        reinterpret_cast<uintptr_t>(scan_factory);
+    auto& arrow_gstate = lstate.local_arrow_global_state->Cast<ArrowScanGlobalState>();
+    arrow_gstate.stream = ArrowTableFunction::ProduceArrowScan(
+        *lstate.local_arrow_function_data, lstate.init_input->column_ids, nullptr);
+    arrow_gstate.done = false;
+    lstate.prefilters.clear();
+    return true;
+  }
 
   // lstate.file_scan = shared_ptr_cast<BaseFileReader, ArrowFileScan>(this);
+  lstate.scan_schema = file_schema;
   lstate.local_arrow_function_data = make_uniq<ArrowScanFunctionData>(
-      &FileIPCStreamFactory::Produce, reinterpret_cast<uintptr_t>(factory.get()));
-  lstate.local_arrow_function_data->schema_root = schema_root;
+      &FileIPCStreamFactory::Produce, reinterpret_cast<uintptr_t>(scan_factory));
+  // Each scan owns (and releases) its copy of the schema
+  NANOARROW_THROW_NOT_OK(
+      ArrowSchemaDeepCopy(&schema_root.arrow_schema,
+                          &lstate.local_arrow_function_data->schema_root.arrow_schema));
   lstate.local_arrow_function_data->arrow_table = arrow_table_type;
   if (!column_indexes.empty()) {
     lstate.init_input = make_uniq<TableFunctionInitInput>(
@@ -63,12 +570,128 @@ bool ArrowFileScan::TryInitializeScan(ClientContext& context,
   lstate.table_function_input = make_uniq<TableFunctionInput>(
       lstate.local_arrow_function_data.get(), lstate.local_arrow_local_state.get(),
       lstate.local_arrow_global_state.get());
+
+  // Remember which output columns are run-end encoded with a flat value type,
+  // so that chunks covered by a single run can be emitted as constant vectors,
+  // and which filters can be checked on the Arrow buffers
+  lstate.run_end_encoded_columns.clear();
+  lstate.prefilters.clear();
+  const auto& column_ids = lstate.init_input->column_ids;
+  const auto& projection_ids = lstate.init_input->projection_ids;
+  idx_t array_idx = 0;
+  for (idx_t scan_idx = 0; scan_idx < column_ids.size(); scan_idx++) {
+    auto column_id = column_ids[scan_idx];
+    if (column_id >= static_cast<idx_t>(schema_root.arrow_schema.n_children)) {
+      // Virtual columns are not part of the record batch
+      continue;
+    }
+    const ArrowSchema& field = *schema_root.arrow_schema.children[column_id];
+    // If output columns are a projection of the scanned columns, columns that are
+    // only scanned for a filter are not part of the output chunk
+    auto out_idx = scan_idx;
+    if (!projection_ids.empty()) {
+      auto projected = std::find(projection_ids.begin(), projection_ids.end(), scan_idx);
+      out_idx = projected == projection_ids.end()
+                    ? DConstants::INVALID_INDEX
+                    : static_cast<idx_t>(projected - projection_ids.begin());
+    }
+    if (string(field.format) == "+r" && field.n_children == 2 &&
+        field.children[1]->format[0] != '+' && out_idx != DConstants::INVALID_INDEX) {
+      lstate.run_end_encoded_columns.push_back(
+          {out_idx, array_idx, field.children[0]->format});
+    }
+    if (filters) {
+      // Filters are keyed by the index of the scanned column
+      auto filter = filters->filters.find(scan_idx);
+      if (filter != filters->filters.end()) {
+        auto prefilter =
+            ArrowPrefilter::Create(*filter->second, types[column_id], field, array_idx);
+        if (prefilter) {
+          lstate.prefilters.push_back(std::move(prefilter));
+        }
+      }
+    }
+    array_idx++;
+  }
   return true;
 }
 void ArrowFileScan::Scan(ClientContext& context, GlobalTableFunctionState& global_state,
                          LocalTableFunctionState& local_state, DataChunk& chunk) {
   auto& lstate = local_state.Cast<ArrowFileLocalState>();
-  ArrowTableFunction::ArrowScanFunction(context, *lstate.table_function_input, chunk);
+  auto& gstate = global_state.Cast<ArrowFileGlobalState>();
+  while (true) {
+    if (!SkipPrefilteredRows(context, gstate, lstate)) {
+      return;
+    }
+    ArrowTableFunction::ArrowScanFunction(context, *lstate.table_function_input, chunk);
+    if (gstate.limit.IsValid()) {
+      gstate.rows_scanned += chunk.size();
+    }
+    if (chunk.size() == 0) {
+      return;
+    }
+    EmitConstantRuns(lstate, chunk);
+    FilterRows(context, lstate, chunk);
+    if (chunk.size() > 0) {
+      return;
+    }
+    // An empty chunk would end the scan of this file: continue with the next one
+    chunk.Reset();
+  }
+}
+
+void ArrowFileScan::FilterRows(ClientContext& context, ArrowFileLocalState& lstate,
+                               DataChunk& chunk) {
+  if (!filters || chunk.size() == 0) {
+    return;
+  }
+  auto& row_filter = lstate.row_filter;
+  if (row_filter.filters.get() != filters.get() ||
+      DynamicFiltersChanged(row_filter.dynamic_filters)) {
+    BuildRowFilter(context, chunk, row_filter);
+  }
+  if (!row_filter.executor) {
+    return;
+  }
+  SelectionVector selection(STANDARD_VECTOR_SIZE);
+  auto count = row_filter.executor->SelectExpression(chunk, selection);
+  if (count < chunk.size()) {
+    chunk.Slice(selection, count);
+  }
+}
+
+void ArrowFileScan::BuildRowFilter(ClientContext& context, DataChunk& chunk,
+                                   ArrowRowFilter& row_filter) {
+  row_filter.filters = filters.get();
+  row_filter.condition.reset();
+  row_filter.executor.reset();
+  row_filter.dynamic_filters.clear();
+
+  vector<unique_ptr<Expression>> conditions;
+  for (const auto& entry : filters->filters) {
+    if (entry.second->filter_type == TableFilterType::OPTIONAL_FILTER) {
+      // Optional filters are hints that only need to be applied to the statistics
+      continue;
+    }
+    // The values are taken before the expression is built: if they change in
+    // between, the expression is built again for the next chunk
+    CollectDynamicFilters(*entry.second, row_filter.dynamic_filters);
+    BoundReferenceExpression column(chunk.data[entry.first].GetType(), entry.first);
+    conditions.push_back(entry.second->ToExpression(column));
+  }
+  if (conditions.empty()) {
+    return;
+  }
+
+  if (conditions.size() == 1) {
+    row_filter.condition = std::move(conditions[0]);
+  } else {
+    auto conjunction =
+        make_uniq<BoundConjunctionExpression>(ExpressionType::CONJUNCTION_AND);
+    conjunction->children = std::move(conditions);
+    row_filter.condition = std::move(conjunction);
+  }
+  row_filter.executor = make_uniq<ExpressionExecutor>(context, *row_filter.condition);
 }
 
 shared_ptr<BaseUnionData> ArrowFileScan::GetUnionData(idx_t file_idx) {
@@ -78,5 +701,18 @@ shared_ptr<BaseUnionData> ArrowFileScan::GetUnionData(idx_t file_idx) {
   return data;
 }
 
+unique_ptr<BaseStatistics> ArrowFileScan::GetStatistics(ClientContext& context,
+                                                        const string& name) {
+  if (!batch_statistics) {
+    return nullptr;
+  }
+  for (idx_t i = 0; i < names.size(); i++) {
+    if (names[i] == name) {
+      return batch_statistics->ColumnStatistics(i);
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace ext_nanoarrow
 }  // namespace duckdb
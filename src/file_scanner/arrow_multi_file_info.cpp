@@ -3,6 +3,8 @@
 #include "ipc/stream_reader/ipc_file_stream_reader.hpp"
 
 #include "duckdb/common/bind_helpers.hpp"
+#include "duckdb/main/config.hpp"
+#include "file_scanner/arrow_cardinality.hpp"
 #include "file_scanner/arrow_file_scan.hpp"
 #include "ipc/stream_factory.hpp"
 
@@ -19,7 +21,12 @@ bool ArrowMultiFileInfo::ParseCopyOption(ClientContext& context, const string& k
                                          BaseFileReaderOptions& options_p,
                                          vector<string>& expected_names,
                                          vector<LogicalType>& expected_types) {
-  // We currently do not have any options for the scanner, so we always return false
+  auto& options = options_p.Cast<ArrowFileReaderOptions>();
+  if (key == "direct_io") {
+    options.direct_io = values.empty() || BooleanValue::Get(values[0].DefaultCastAs(
+                                              LogicalType::BOOLEAN));
+    return true;
+  }
   return false;
 }
 
@@ -30,31 +37,40 @@ unique_ptr<MultiFileReaderInterface> ArrowMultiFileInfo::InitializeInterface(
 
 bool ArrowMultiFileInfo::ParseOption(ClientContext& context, const string& key,
                                      const Value& val, MultiFileOptions& file_options,
-                                     BaseFileReaderOptions& options) {
-  // We currently do not have any options for the scanner, so we always return false
+                                     BaseFileReaderOptions& options_p) {
+  auto& options = options_p.Cast<ArrowFileReaderOptions>();
+  if (key == "direct_io") {
+    options.direct_io = BooleanValue::Get(val);
+    return true;
+  }
   return false;
 }
 
 void ArrowMultiFileInfo::FinalizeCopyBind(ClientContext& context,
                                           BaseFileReaderOptions& options_p,
                                           const vector<string>& expected_names,
-                                          const vector<LogicalType>& expected_types) {}
-
-struct ArrowMultiFileData final : public TableFunctionData {
-  ArrowMultiFileData() = default;
+                                          const vector<LogicalType>& expected_types) {
+  options_p.Cast<ArrowFileReaderOptions>().bulk_load = true;
+}
 
-  unique_ptr<ArrowFileScan> file_scan;
-};
+static const ArrowFileReaderOptions& GetReaderOptions(
+    const MultiFileBindData& bind_data) {
+  return bind_data.bind_data->Cast<ArrowMultiFileData>().options;
+}
 
 unique_ptr<TableFunctionData> ArrowMultiFileInfo::InitializeBindData(
     MultiFileBindData& multi_file_data, unique_ptr<BaseFileReaderOptions> options_p) {
-  return make_uniq<ArrowMultiFileData>();
+  auto result = make_uniq<ArrowMultiFileData>();
+  if (options_p) {
+    result->options = options_p->Cast<ArrowFileReaderOptions>();
+  }
+  return std::move(result);
 }
 
 void ArrowMultiFileInfo::BindReader(ClientContext& context,
                                     vector<LogicalType>& return_types,
                                     vector<string>& names, MultiFileBindData& bind_data) {
-  ArrowFileReaderOptions options;
+  ArrowFileReaderOptions options = GetReaderOptions(bind_data);
   auto& multi_file_list = *bind_data.file_list;
   if (!bind_data.file_options.union_by_name) {
     bind_data.reader_bind = bind_data.multi_file_reader->BindReader(
@@ -67,6 +83,29 @@ void ArrowMultiFileInfo::BindReader(ClientContext& context,
         bind_data.file_options);
   }
   D_ASSERT(names.size() == return_types.size());
+
+  // Rows of a single file come out in file order (if insertion order is preserved),
+  // so the file's declared sort order is the order of the scan. Nothing checks that
+  // the writer declared it correctly, so it's only used if the user opted in.
+  Value trust_sort_order;
+  if (!bind_data.file_options.union_by_name && bind_data.initial_reader &&
+      multi_file_list.GetExpandResult() == FileExpandResult::SINGLE_FILE &&
+      context.TryGetCurrentSetting("arrow_trust_sort_order", trust_sort_order) &&
+      !trust_sort_order.IsNull() && BooleanValue::Get(trust_sort_order)) {
+    auto& file_scan = bind_data.initial_reader->Cast<ArrowFileScan>();
+    bind_data.bind_data->Cast<ArrowMultiFileData>().sort_order =
+        ArrowSortOrder::FromSchema(file_scan.schema_root.arrow_schema);
+  }
+
+  // Row counts for the optimizer (e.g., to pick build sides of joins). The file
+  // opened for the schema is counted through its reader.
+  optional_ptr<ArrowFileScan> initial_reader;
+  if (bind_data.initial_reader) {
+    initial_reader = &bind_data.initial_reader->Cast<ArrowFileScan>();
+  }
+  ArrowCardinality::CountFiles(context, multi_file_list,
+                               bind_data.bind_data->Cast<ArrowMultiFileData>(),
+                               initial_reader);
 }
 
 void ArrowMultiFileInfo::FinalizeBindData(MultiFileBindData& multi_file_data) {}
@@ -81,15 +120,32 @@ optional_idx ArrowMultiFileInfo::MaxThreads(const MultiFileBindData& bind_data_p
     // always launch max threads if we are reading multiple files
     return {};
   }
-  // Otherwise, only one thread
+  // Otherwise, one thread per part of the file that can be scanned on its own
+  if (!global_state.readers.empty() && global_state.readers[0]->reader) {
+    auto& file_scan = global_state.readers[0]->reader->Cast<ArrowFileScan>();
+    return MaxValue<idx_t>(file_scan.scan_units.size(), 1);
+  }
   return 1;
 }
 
 unique_ptr<GlobalTableFunctionState> ArrowMultiFileInfo::InitializeGlobalState(
     ClientContext& context, MultiFileBindData& bind_data,
     MultiFileGlobalState& global_state) {
-  return make_uniq<ArrowFileGlobalState>(
-      context, bind_data.file_list->GetTotalFileCount(), bind_data, global_state);
+  auto file_count = bind_data.file_list->GetTotalFileCount();
+  auto result =
+      make_uniq<ArrowFileGlobalState>(context, file_count, bind_data, global_state);
+  Value sliced_batch_size;
+  result->sliced_body_size = IPCFileStreamReader::SLICED_BODY_SIZE;
+  if (context.TryGetCurrentSetting("arrow_sliced_batch_size", sliced_batch_size) &&
+      !sliced_batch_size.IsNull()) {
+    result->sliced_body_size = DBConfig::ParseMemoryLimit(sliced_batch_size.ToString());
+  }
+  auto depth = ArrowFilePrefetcher::GetDepth(context);
+  if (depth > 0 && file_count > 1 && !bind_data.file_options.union_by_name) {
+    result->prefetcher = make_uniq<ArrowFilePrefetcher>(
+        *bind_data.file_list, file_count, GetReaderOptions(bind_data), *result, depth);
+  }
+  return std::move(result);
 }
 
 unique_ptr<LocalTableFunctionState> ArrowMultiFileInfo::InitializeLocalState(
@@ -100,19 +156,43 @@ unique_ptr<LocalTableFunctionState> ArrowMultiFileInfo::InitializeLocalState(
 shared_ptr<BaseFileReader> ArrowMultiFileInfo::CreateReader(
     ClientContext& context, GlobalTableFunctionState& gstate_p, BaseUnionData& union_data,
     const MultiFileBindData& bind_data) {
-  return make_shared_ptr<ArrowFileScan>(context, union_data.GetFileName());
+  auto& gstate = gstate_p.Cast<ArrowFileGlobalState>();
+  if (gstate.LimitReached()) {
+    return make_shared_ptr<ArrowFileScan>(union_data.GetFileName(), bind_data.columns);
+  }
+  return make_shared_ptr<ArrowFileScan>(context, union_data.GetFileName(),
+                                        GetReaderOptions(bind_data),
+                                        gstate.schema_cache);
 }
 
 shared_ptr<BaseFileReader> ArrowMultiFileInfo::CreateReader(
     ClientContext& context, GlobalTableFunctionState& gstate_p,
     const OpenFileInfo& file_info, idx_t file_idx, const MultiFileBindData& bind_data) {
-  return make_shared_ptr<ArrowFileScan>(context, file_info.path);
+  auto& gstate = gstate_p.Cast<ArrowFileGlobalState>();
+  if (gstate.LimitReached()) {
+    // Enough rows were produced by earlier files: don't even open this one
+    if (gstate.prefetcher) {
+      gstate.prefetcher->Cancel();
+    }
+    return make_shared_ptr<ArrowFileScan>(file_info.path, bind_data.columns);
+  }
+  if (gstate.prefetcher) {
+    auto prefetched = gstate.prefetcher->Take(file_idx);
+    gstate.prefetcher->Schedule(file_idx);
+    if (prefetched) {
+      return std::move(prefetched);
+    }
+  }
+  return make_shared_ptr<ArrowFileScan>(context, file_info.path,
+                                        GetReaderOptions(bind_data),
+                                        gstate.schema_cache);
 }
 
 shared_ptr<BaseFileReader> ArrowMultiFileInfo::CreateReader(
     ClientContext& context, const OpenFileInfo& file, BaseFileReaderOptions& options,
     const MultiFileOptions& file_options) {
-  return make_shared_ptr<ArrowFileScan>(context, file.path);
+  return make_shared_ptr<ArrowFileScan>(context, file.path,
+                                        options.Cast<ArrowFileReaderOptions>());
 }
 
 void ArrowMultiFileInfo::FinalizeReader(ClientContext& context, BaseFileReader& reader,
@@ -128,21 +208,30 @@ void ArrowMultiFileInfo::FinishReading(ClientContext& context,
 
 unique_ptr<NodeStatistics> ArrowMultiFileInfo::GetCardinality(
     const MultiFileBindData& bind_data, idx_t file_count) {
-  // TODO: Here is where we might set statistics, for optimizations if we have them
-  // e.g., cardinality from the file footer
-  return make_uniq<NodeStatistics>();
+  auto& arrow_data = bind_data.bind_data->Cast<ArrowMultiFileData>();
+  if (arrow_data.counted_files == 0) {
+    return make_uniq<NodeStatistics>();
+  }
+  if (arrow_data.counted_rows_exact && arrow_data.counted_files == file_count) {
+    return make_uniq<NodeStatistics>(arrow_data.counted_rows, arrow_data.counted_rows);
+  }
+  // Extrapolate from the files we counted
+  auto rows_per_file = static_cast<double>(arrow_data.counted_rows) /
+                       static_cast<double>(arrow_data.counted_files);
+  return make_uniq<NodeStatistics>(
+      static_cast<idx_t>(rows_per_file * static_cast<double>(file_count)));
 }
 
 unique_ptr<BaseStatistics> ArrowMultiFileInfo::GetStatistics(ClientContext& context,
                                                              BaseFileReader& reader,
                                                              const string& name) {
-  return nullptr;
+  return reader.Cast<ArrowFileScan>().GetStatistics(context, name);
 }
 
 double ArrowMultiFileInfo::GetProgressInFile(ClientContext& context,
                                              const BaseFileReader& reader) {
   auto& file_scan = reader.Cast<ArrowFileScan>();
-  if (!file_scan.factory->reader) {
+  if (!file_scan.factory || !file_scan.factory->reader) {
     // We are done with this file
     return 100;
   }
@@ -0,0 +1,237 @@
+#include "file_scanner/arrow_prefilter.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "duckdb/common/operator/comparison_operators.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/in_filter.hpp"
+#include "duckdb/planner/filter/optional_filter.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+bool IsSupportedComparison(ExpressionType type) {
+  switch (type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//! Compares like DuckDB does (e.g., NaN is larger than any other value)
+template <class T>
+bool CompareValue(ExpressionType type, T value, T constant) {
+  switch (type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return Equals::Operation(value, constant);
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return NotEquals::Operation(value, constant);
+    case ExpressionType::COMPARE_LESSTHAN:
+      return LessThan::Operation(value, constant);
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return GreaterThan::Operation(value, constant);
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return LessThanEquals::Operation(value, constant);
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return GreaterThanEquals::Operation(value, constant);
+    default:
+      return true;
+  }
+}
+
+template <class T>
+struct LessThanOperation {
+  bool operator()(const T& left, const T& right) const {
+    return LessThan::Operation(left, right);
+  }
+};
+
+}  // namespace
+
+class ArrowPrefilterConditions {
+ public:
+  virtual ~ArrowPrefilterConditions() = default;
+  virtual bool MayMatch(const ArrowArray& column, int64_t start, int64_t end) const = 0;
+};
+
+namespace {
+
+template <class T>
+class TypedPrefilterConditions final : public ArrowPrefilterConditions {
+ public:
+  bool MayMatch(const ArrowArray& column, int64_t start, int64_t end) const override {
+    if (column.n_buffers != 2 || !column.buffers[1]) {
+      return true;
+    }
+    auto values = static_cast<const T*>(column.buffers[1]) + column.offset;
+    auto validity = static_cast<const uint8_t*>(column.buffers[0]);
+    for (int64_t row = start; row < end; row++) {
+      if (validity && column.null_count != 0 &&
+          !ArrowBitGet(validity, column.offset + row)) {
+        return true;
+      }
+      auto value = values[row];
+      bool match = true;
+      for (idx_t i = 0; match && i < comparisons.size(); i++) {
+        match = CompareValue<T>(comparisons[i].first, value, comparisons[i].second);
+      }
+      for (idx_t i = 0; match && i < sorted_lists.size(); i++) {
+        match = std::binary_search(sorted_lists[i].begin(), sorted_lists[i].end(),
+                                   value, LessThanOperation<T>());
+      }
+      if (match) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  vector<std::pair<ExpressionType, T>> comparisons;
+  vector<vector<T>> sorted_lists;
+};
+
+}  // namespace
+
+ArrowPrefilter::~ArrowPrefilter() = default;
+
+unique_ptr<ArrowPrefilter> ArrowPrefilter::Create(const TableFilter& filter,
+                                                  const LogicalType& type,
+                                                  const ArrowSchema& field,
+                                                  idx_t array_idx) {
+  // Only plain (not dictionary encoded) integer and floating point columns
+  if (field.dictionary || !field.format || field.format[0] == '\0' ||
+      field.format[1] != '\0' || !strchr("cCsSiIlLfg", field.format[0])) {
+    return nullptr;
+  }
+
+  auto result = unique_ptr<ArrowPrefilter>(new ArrowPrefilter());
+  result->array_idx = array_idx;
+  if (!result->AddFilter(filter, type) ||
+      (result->comparisons.empty() && result->in_lists.empty())) {
+    return nullptr;
+  }
+  switch (field.format[0]) {
+    case 'c':
+      result->conditions = result->ConvertConditions<int8_t>();
+      break;
+    case 'C':
+      result->conditions = result->ConvertConditions<uint8_t>();
+      break;
+    case 's':
+      result->conditions = result->ConvertConditions<int16_t>();
+      break;
+    case 'S':
+      result->conditions = result->ConvertConditions<uint16_t>();
+      break;
+    case 'i':
+      result->conditions = result->ConvertConditions<int32_t>();
+      break;
+    case 'I':
+      result->conditions = result->ConvertConditions<uint32_t>();
+      break;
+    case 'l':
+      result->conditions = result->ConvertConditions<int64_t>();
+      break;
+    case 'L':
+      result->conditions = result->ConvertConditions<uint64_t>();
+      break;
+    case 'f':
+      result->conditions = result->ConvertConditions<float>();
+      break;
+    case 'g':
+      result->conditions = result->ConvertConditions<double>();
+      break;
+    default:
+      return nullptr;
+  }
+  return result;
+}
+
+template <class T>
+unique_ptr<ArrowPrefilterConditions> ArrowPrefilter::ConvertConditions() const {
+  auto result = make_uniq<TypedPrefilterConditions<T>>();
+  for (const auto& comparison : comparisons) {
+    result->comparisons.emplace_back(comparison.type, comparison.constant.GetValue<T>());
+  }
+  for (const auto& in_list : in_lists) {
+    vector<T> sorted;
+    sorted.reserve(in_list.size());
+    for (const auto& value : in_list) {
+      sorted.push_back(value.GetValue<T>());
+    }
+    std::sort(sorted.begin(), sorted.end(), LessThanOperation<T>());
+    result->sorted_lists.push_back(std::move(sorted));
+  }
+  return std::move(result);
+}
+
+bool ArrowPrefilter::AddFilter(const TableFilter& filter, const LogicalType& type) {
+  switch (filter.filter_type) {
+    case TableFilterType::CONSTANT_COMPARISON: {
+      auto& constant_filter = filter.Cast<ConstantFilter>();
+      if (!IsSupportedComparison(constant_filter.comparison_type) ||
+          constant_filter.constant.IsNull() || constant_filter.constant.type() != type) {
+        return false;
+      }
+      comparisons.push_back({constant_filter.comparison_type, constant_filter.constant});
+      return true;
+    }
+    case TableFilterType::IN_FILTER: {
+      auto& in_filter = filter.Cast<InFilter>();
+      for (const auto& value : in_filter.values) {
+        if (value.IsNull() || value.type() != type) {
+          return false;
+        }
+      }
+      in_lists.push_back(in_filter.values);
+      return true;
+    }
+    case TableFilterType::CONJUNCTION_AND: {
+      auto& conjunction = filter.Cast<ConjunctionAndFilter>();
+      for (const auto& child : conjunction.child_filters) {
+        if (!AddFilter(*child, type)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case TableFilterType::OPTIONAL_FILTER: {
+      // Rows that fail an optional filter are removed by another filter later on,
+      // so skipping them early is fine. If the child isn't supported, it is just
+      // not used.
+      auto& optional_filter = filter.Cast<OptionalFilter>();
+      if (optional_filter.child_filter) {
+        auto comparison_count = comparisons.size();
+        auto in_list_count = in_lists.size();
+        if (!AddFilter(*optional_filter.child_filter, type)) {
+          comparisons.resize(comparison_count);
+          in_lists.resize(in_list_count);
+        }
+      }
+      return true;
+    }
+    case TableFilterType::IS_NOT_NULL:
+      // Null values are assumed to pass anyway
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool ArrowPrefilter::MayMatch(const ArrowArray& column, int64_t start,
+                              int64_t end) const {
+  return conditions->MayMatch(column, start, end);
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// file_scanner/arrow_cardinality.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/multi_file/multi_file_list.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/storage/object_cache.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+class ArrowFileScan;
+struct ArrowMultiFileData;
+
+//! Number of rows of one version of a file, cached across queries
+class ArrowFileRowCount : public ObjectCacheEntry {
+ public:
+  ArrowFileRowCount(int64_t last_modified, idx_t file_size, idx_t row_count, bool exact)
+      : last_modified(last_modified),
+        file_size(file_size),
+        row_count(row_count),
+        exact(exact) {}
+
+  static string ObjectType() { return "nanoarrow_row_count"; }
+  string GetObjectType() override { return ObjectType(); }
+
+  int64_t last_modified;
+  idx_t file_size;
+  idx_t row_count;
+  //! False if the row count was extrapolated from the first record batches
+  bool exact;
+};
+
+//! Column statistics of one version of a file written with
+//! COPY ... (BATCH_STATISTICS true), cached across queries. Only what the optimizer
+//! needs is kept (not the statistics or bloom filters of each record batch).
+class ArrowFileColumnStatistics : public ObjectCacheEntry {
+ public:
+  ArrowFileColumnStatistics(int64_t last_modified, idx_t file_size)
+      : last_modified(last_modified), file_size(file_size) {}
+
+  static string ObjectType() { return "nanoarrow_column_statistics"; }
+  string GetObjectType() override { return ObjectType(); }
+
+  int64_t last_modified;
+  idx_t file_size;
+  //! False if the file has no batch statistics, which is cached as well
+  bool has_statistics = false;
+  vector<string> names;
+  //! The types the statistics were written for
+  vector<LogicalType> types;
+  idx_t row_count = 0;
+  //! Statistics of each column over all record batches
+  vector<unique_ptr<BaseStatistics>> columns;
+};
+
+//! Row counts of read_arrow() scans for the optimizer. Files with batch statistics
+//! have their row count in the statistics, IPC files are extrapolated from their first
+//! record batch header and the footer, and only streams have their headers decoded
+//! (their bodies are never read).
+struct ArrowCardinality {
+  //! Files whose rows are counted at bind time, the others are extrapolated. They are
+  //! counted on the binding thread, so this is kept small for remote files.
+  static constexpr idx_t MAX_COUNTED_FILES = 8;
+  //! Record batch headers read per stream before extrapolating the rest of the
+  //! stream. Each header past the read-ahead window is a separate request.
+  static constexpr idx_t MAX_COUNTED_BATCHES = 16;
+  //! Only headers are needed, so there is no point in reading ahead much
+  static constexpr idx_t READ_AHEAD_SIZE = 64 * 1024;
+  //! Files whose statistics are read to answer aggregates while optimizing. Each
+  //! file takes a request for its schema and one for its statistics (unless they are
+  //! cached), so scans of more files are executed instead.
+  static constexpr idx_t MAX_STATISTICS_FILES = 256;
+
+  //! Counts the rows of (a sample of) the files of a scan into the bind data. The
+  //! file that was opened to bind the scan (if given) is counted through its reader
+  //! instead of being opened again.
+  static void CountFiles(ClientContext& context, MultiFileList& files,
+                         ArrowMultiFileData& data,
+                         optional_ptr<ArrowFileScan> initial_reader = nullptr);
+  //! Returns the row count of a file, from the object cache if the file didn't
+  //! change since it was counted. Returns nullptr if the file can't be counted.
+  static shared_ptr<ArrowFileRowCount> CountRows(ClientContext& context,
+                                                 const string& path);
+  //! Returns the row count of a file that is open already, from its batch statistics
+  //! or the footer of IPC files. Returns false if the file has neither.
+  static bool CountRows(ArrowFileScan& file_scan, idx_t& row_count, bool& exact);
+  //! Returns the column statistics of a file, from the object cache if the file
+  //! didn't change since they were read. Only the schema and the statistics at the
+  //! end of the file are read. Returns nullptr if the file can't be read.
+  static shared_ptr<ArrowFileColumnStatistics> ReadColumnStatistics(
+      ClientContext& context, const string& path);
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
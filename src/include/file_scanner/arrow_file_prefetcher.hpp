@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// file_scanner/arrow_file_prefetcher.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/multi_file/multi_file_list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+class ArrowFileScan;
+class ArrowFileReaderOptions;
+struct ArrowFileGlobalState;
+
+//! A file that a task of the scheduler opens ahead of the scan
+struct ArrowPrefetchedFile {
+  enum class State : uint8_t { QUEUED, OPENING, OPENED, CANCELLED };
+
+  mutex lock;
+  //! Signaled when an OPENING file is OPENED
+  std::condition_variable opened;
+  State state = State::QUEUED;
+  //! The opened file, nullptr if opening it failed or was cancelled
+  shared_ptr<ArrowFileScan> file_scan;
+  ErrorData error;
+};
+
+//! Opens the files that a multi-file scan reads next in the background: a thread
+//! that finishes a file then finds the next one with its schema read, its scan
+//! units set up and its first record batches in the read-ahead window, instead of
+//! waiting for each of these reads (which add up on remote storage). The files are
+//! opened by tasks of DuckDB's scheduler, so they run on the query's threads, and
+//! files that no thread started opening yet are dropped once the query is
+//! interrupted, reaches its LIMIT or finishes.
+class ArrowFilePrefetcher {
+ public:
+  ArrowFilePrefetcher(MultiFileList& files, idx_t file_count,
+                      const ArrowFileReaderOptions& options, ArrowFileGlobalState& gstate,
+                      idx_t depth);
+  //! Cancels the files that aren't being opened and waits for the others
+  ~ArrowFilePrefetcher();
+
+  //! Returns the scan of a file that was opened in the background (waiting for it
+  //! if it is being opened), or nullptr if it wasn't prefetched or no thread started
+  //! opening it yet. Throws the errors of opening the file.
+  shared_ptr<ArrowFileScan> Take(idx_t file_idx);
+  //! Schedules opening the files that follow file_idx, up to depth files ahead
+  void Schedule(idx_t file_idx);
+  //! Stops opening files, e.g., because the LIMIT of the query was reached
+  void Cancel();
+  //! Whether files that weren't opened yet are no longer needed
+  bool Cancelled() const;
+  //! Number of files that were scanned after they were opened in the background
+  idx_t PrefetchedFileCount() const { return prefetched_files.load(); }
+
+  //! Number of files opened ahead, from the arrow_prefetch_files setting, or 0 if
+  //! the scheduler has no threads to open them
+  static idx_t GetDepth(ClientContext& context);
+
+  MultiFileList& files;
+  idx_t file_count;
+  const ArrowFileReaderOptions& options;
+  ArrowFileGlobalState& gstate;
+
+ private:
+  idx_t depth;
+  unique_ptr<ProducerToken> token;
+  atomic<bool> cancelled{false};
+  atomic<idx_t> prefetched_files{0};
+
+  mutex lock;
+  //! The files before this one were prefetched or opened by a scan thread
+  idx_t next_file = 0;
+  unordered_map<idx_t, shared_ptr<ArrowPrefetchedFile>> pending;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include "file_scanner/arrow_multi_file_info.hpp"
+#include "ipc/batch_statistics.hpp"
+#include "ipc/ipc_metadata.hpp"
+#include "ipc/shared_scan.hpp"
 #include "ipc/stream_factory.hpp"
 
 #include "duckdb/common/multi_file/base_file_reader.hpp"
@@ -15,24 +19,49 @@
 namespace duckdb {
 namespace ext_nanoarrow {
 
+//! A byte range of an IPC file holding consecutive record batch messages, which is
+//! scanned by a single thread
+struct ArrowFileScanUnit {
+  idx_t start;
+  idx_t end;
+};
+
 //! This class refers to an Arrow File Scan
 class ArrowFileScan : public BaseFileReader {
  public:
-  explicit ArrowFileScan(ClientContext& context, const string& file_name);
-  ~ArrowFileScan() override {
-    // Release is done by the arrow scanner
-    schema_root.arrow_schema.release = nullptr;
-  };
+  //! Opens the file. If a schema cache is given, the conversion of the schema is
+  //! shared with the other files of the scan that have the same schema.
+  ArrowFileScan(ClientContext& context, const string& file_name,
+                const ArrowFileReaderOptions& options,
+                optional_ptr<ArrowFileSchemaCache> schema_cache = nullptr);
+  //! A scan of a file that is never opened (e.g., because a pushed down LIMIT was
+  //! already satisfied by other files)
+  ArrowFileScan(const string& file_name,
+                const vector<MultiFileColumnDefinition>& expected_columns);
+  ~ArrowFileScan() override = default;
 
-  //! Factory of this stream
+  //! Factory of this stream, nullptr if the file is never opened
   unique_ptr<FileIPCStreamFactory> factory;
 
+  //! Minimum size of the ranges of a file that are handed out to different threads
+  static constexpr idx_t MIN_SCAN_UNIT_SIZE = 1024 * 1024;
+  //! Ranges of the file that can be scanned in parallel, found through the footer
+  //! of IPC files. Empty if the file has to be scanned as a whole.
+  vector<ArrowFileScanUnit> scan_units;
+
   string GetReaderType() const override;
 
   const vector<string>& GetNames();
   const vector<LogicalType>& GetTypes();
   ArrowSchemaWrapper schema_root;
   ArrowTableType arrow_table_type;
+  //! The converted schema, shared with files that have the same schema message
+  shared_ptr<ArrowFileSchema> file_schema;
+  //! Statistics of the record batches, if the writer appended them to the file
+  shared_ptr<ArrowFileStatistics> batch_statistics;
+
+  //! Reads the first record batches of the file ahead of the scan
+  void Prefetch();
 
   bool TryInitializeScan(ClientContext& context, GlobalTableFunctionState& gstate,
                          LocalTableFunctionState& lstate) override;
@@ -40,10 +69,45 @@ class ArrowFileScan : public BaseFileReader {
             LocalTableFunctionState& local_state, DataChunk& chunk) override;
 
   shared_ptr<BaseUnionData> GetUnionData(idx_t file_idx) override;
+  //! Statistics of a column over all record batches of the file, nullptr if the
+  //! file has no batch statistics
+  unique_ptr<BaseStatistics> GetStatistics(ClientContext& context,
+                                           const string& name) override;
 
  private:
+  //! Splits the record batches listed in the footer into scan units
+  void InitializeScanUnits(ClientContext& context);
+  //! Size of the scan units of COPY ... FROM, which hold about a row group of rows
+  idx_t BulkLoadScanUnitSize(const vector<IPCFileBlock>& blocks);
+  //! Joins the other running scans of the file, unless record batches are served
+  //! from the batch cache. Looks up the identity of the file for either.
+  void RegisterSharedScan(ClientContext& context);
+  //! Returns the factory that scans the next part of the file, or nullptr if the
+  //! whole file was handed out
+  FileIPCStreamFactory* NextScanFactory(ClientContext& context,
+                                        ArrowFileGlobalState& gstate,
+                                        ArrowFileLocalState& lstate, idx_t& unit_idx);
+  //! Removes the rows of a scanned chunk that don't pass the pushed down filters
+  void FilterRows(ClientContext& context, ArrowFileLocalState& lstate, DataChunk& chunk);
+  //! Builds the expression of the filters that are applied to the rows of chunk
+  void BuildRowFilter(ClientContext& context, DataChunk& chunk,
+                      ArrowRowFilter& row_filter);
+
   vector<string> names;
   vector<LogicalType> types;
+  ArrowFileReaderOptions options;
+  //! The next scan unit to hand out, counted from the first one
+  idx_t next_scan_unit = 0;
+  //! Scan unit that is handed out first, the units before it are handed out last
+  idx_t first_scan_unit = 0;
+  //! Registration with the other scans of the file that are running, once the file
+  //! is scanned (nullptr if scans aren't shared)
+  unique_ptr<ArrowSharedScanHandle> shared_scan;
+  bool shared_scan_checked = false;
+  //! This version of the file in the batch cache and the shared scans. It is looked
+  //! up once, not by the reader of every scan unit (which would be a request each
+  //! on remote file systems). nullptr if neither is used.
+  unique_ptr<ArrowBatchCacheFile> cache_file;
 };
 }  // namespace ext_nanoarrow
 }  // namespace duckdb
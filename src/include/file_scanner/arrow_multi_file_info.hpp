@@ -9,16 +9,106 @@
 #pragma once
 
 #include "duckdb/common/multi_file/multi_file_function.hpp"
+#include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/function/table/arrow.hpp"
+#include "duckdb/planner/filter/dynamic_filter.hpp"
+#include "file_scanner/arrow_file_prefetcher.hpp"
+#include "file_scanner/arrow_prefilter.hpp"
+#include "ipc/schema_index.hpp"
+#include "ipc/sort_order.hpp"
+#include "ipc/stream_factory.hpp"
 
 namespace duckdb {
 namespace ext_nanoarrow {
 
-//! We might have arrow specific options one day
-class ArrowFileReaderOptions : public BaseFileReaderOptions {};
+//! Arrow specific options of read_arrow
+class ArrowFileReaderOptions : public BaseFileReaderOptions {
+ public:
+  //! Read files with O_DIRECT, bypassing the page cache
+  bool direct_io = false;
+  //! The scan feeds COPY ... FROM, which inserts each scan unit as one batch
+  bool bulk_load = false;
+};
 
 class ArrowFileScan;
 
+//! Arrow specific bind data of read_arrow
+struct ArrowMultiFileData final : public TableFunctionData {
+  ArrowMultiFileData() = default;
+
+  ArrowFileReaderOptions options;
+  //! Maximum number of rows the query needs (LIMIT + OFFSET), if a LIMIT without
+  //! filters or ordering sits directly on top of the scan
+  optional_idx limit;
+  //! Order the rows of the scanned file are sorted in, if the scan reads a single
+  //! file that declares its sort order
+  vector<ArrowSortKey> sort_order;
+  //! Rows of the files that were counted at bind time (a sample for large globs)
+  idx_t counted_files = 0;
+  idx_t counted_rows = 0;
+  bool counted_rows_exact = false;
+};
+
+//! The DuckDB side of a file schema
+struct ArrowFileSchema {
+  ArrowTableType arrow_table_type;
+  vector<string> names;
+  vector<LogicalType> types;
+  //! Where the columns are found in record batches, shared by all readers
+  shared_ptr<IPCSchemaIndex> schema_index;
+};
+
+//! Converted schemas of the files of one scan, by schema message. Files with the
+//! same schema share one ArrowFileSchema instead of each converting it again, which
+//! also tells a thread that it can keep its scan state for the next file.
+class ArrowFileSchemaCache {
+ public:
+  shared_ptr<ArrowFileSchema> Get(const string& schema_message) {
+    lock_guard<mutex> guard(lock);
+    auto entry = schemas.find(schema_message);
+    return entry == schemas.end() ? nullptr : entry->second;
+  }
+  shared_ptr<ArrowFileSchema> Insert(const string& schema_message,
+                                     shared_ptr<ArrowFileSchema> schema) {
+    lock_guard<mutex> guard(lock);
+    // Another thread may have converted the same schema in the meantime
+    return schemas.emplace(schema_message, std::move(schema)).first->second;
+  }
+
+ private:
+  mutex lock;
+  unordered_map<string, shared_ptr<ArrowFileSchema>> schemas;
+};
+
+//! A projected column that is run-end encoded in the file
+struct ArrowRunEndEncodedColumn {
+  //! Index of the column in the output chunk
+  idx_t output_idx;
+  //! Index of the column in the (projected) record batch
+  idx_t array_idx;
+  //! Format string of the run ends child
+  string run_ends_format;
+};
+
+//! The pushed down filters of a scan as an expression that is applied to the
+//! converted chunks. It is built once per filter set, and again when one of the
+//! dynamic filters (e.g., the boundary of a Top-N) changed its value.
+struct ArrowRowFilter {
+  //! A dynamic filter with the value it had when the expression was built
+  struct DynamicFilterValue {
+    shared_ptr<DynamicFilterData> data;
+    bool initialized;
+    Value constant;
+  };
+
+  //! The filter set the expression was built from, nullptr if none was built yet
+  optional_ptr<const TableFilterSet> filters;
+  //! nullptr if none of the filters has to be applied to the rows
+  unique_ptr<Expression> condition;
+  unique_ptr<ExpressionExecutor> executor;
+  vector<DynamicFilterValue> dynamic_filters;
+};
+
 //! The Arrow Local File State, basically refers to the Scan of one Arrow File
 //! This is done by calling the Arrow Scan directly on one file.
 struct ArrowFileLocalState : public LocalTableFunctionState {
@@ -30,12 +120,25 @@ struct ArrowFileLocalState : public LocalTableFunctionState {
 
   ExecutionContext& execution_context;
 
+  //! Factory of the reader of the current scan unit, if it isn't the first unit of
+  //! the file (which uses the factory of the file scan)
+  unique_ptr<FileIPCStreamFactory> unit_factory;
+
+  //! Schema of the files scanned with the current arrow scan state
+  shared_ptr<ArrowFileSchema> scan_schema;
+
   //! Each local state refers to an Arrow Scan on a local file
   unique_ptr<ArrowScanFunctionData> local_arrow_function_data;
   unique_ptr<TableFunctionInitInput> init_input;
   unique_ptr<GlobalTableFunctionState> local_arrow_global_state;
   unique_ptr<LocalTableFunctionState> local_arrow_local_state;
   unique_ptr<TableFunctionInput> table_function_input;
+  //! Output columns that are run-end encoded in the file
+  vector<ArrowRunEndEncodedColumn> run_end_encoded_columns;
+  //! Pushed down filters that are checked on the record batch before conversion
+  vector<unique_ptr<ArrowPrefilter>> prefilters;
+  //! Pushed down filters that are applied to the converted rows
+  ArrowRowFilter row_filter;
 };
 
 struct ArrowFileGlobalState : public GlobalTableFunctionState {
@@ -43,13 +146,47 @@ struct ArrowFileGlobalState : public GlobalTableFunctionState {
   ArrowFileGlobalState(ClientContext& context_p, idx_t total_file_count,
                        const MultiFileBindData& bind_data,
                        MultiFileGlobalState& global_state)
-      : global_state(global_state), context(context_p) {};
+      : global_state(global_state),
+        context(context_p),
+        limit(bind_data.bind_data->Cast<ArrowMultiFileData>().limit) {};
 
   ~ArrowFileGlobalState() override = default;
 
   const MultiFileGlobalState& global_state;
   ClientContext& context;
   set<idx_t> files;
+
+  //! Schemas of the files that were opened so far
+  ArrowFileSchemaCache schema_cache;
+
+  //! Percentage of record batches to read if a SYSTEM sample was pushed down
+  double sample_percentage = 100;
+  //! Seed of the pushed down sample, if it is repeatable
+  optional_idx sample_seed;
+
+  //! Maximum number of rows the query needs, if a LIMIT was pushed down
+  optional_idx limit;
+  //! Rows produced by all files so far, to stop opening files once the limit is hit
+  atomic<idx_t> rows_scanned{0};
+
+  //! Rows that prefilters skipped without converting them
+  atomic<idx_t> prefiltered_rows{0};
+
+  //! Record batch bodies of at least this size are read in slices of rows, none are
+  //! if this is 0
+  idx_t sliced_body_size = 0;
+  //! Record batches that were read in slices
+  atomic<idx_t> sliced_batches{0};
+  //! Record batches that were served from the batch cache or a shared scan window
+  atomic<idx_t> cached_batches{0};
+
+  bool LimitReached() const {
+    return limit.IsValid() && rows_scanned.load() >= limit.GetIndex();
+  }
+
+  //! Opens the next files in the background, nullptr if files aren't prefetched.
+  //! Declared last: files that are still being opened use this state.
+  unique_ptr<ArrowFilePrefetcher> prefetcher;
 };
 
 struct ArrowMultiFileInfo : MultiFileReaderInterface {
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// file_scanner/arrow_prefilter.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "nanoarrow/nanoarrow.hpp"
+
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/planner/table_filter.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+class ArrowPrefilterConditions;
+
+//! A pushed down filter on a primitive column that is checked on the Arrow buffers
+//! of a record batch, before the rows are converted to DuckDB vectors. Filters that
+//! hash joins derive from their build side (min/max and IN lists) are the main use.
+class ArrowPrefilter {
+ public:
+  //! Creates the prefilter of a column if the filter and the Arrow type of the
+  //! column are supported, otherwise returns nullptr
+  static unique_ptr<ArrowPrefilter> Create(const TableFilter& filter,
+                                           const LogicalType& type,
+                                           const ArrowSchema& field, idx_t array_idx);
+  ~ArrowPrefilter();
+
+  //! Returns false if none of the values of rows [start, end) of the column pass
+  //! the filter. Null values are assumed to pass.
+  bool MayMatch(const ArrowArray& column, int64_t start, int64_t end) const;
+
+  //! Index of the column in the (projected) record batch
+  idx_t array_idx;
+
+ private:
+  struct Comparison {
+    ExpressionType type;
+    Value constant;
+  };
+
+  ArrowPrefilter() = default;
+  //! Adds the conditions of a filter, returns false if one of them is not supported
+  bool AddFilter(const TableFilter& filter, const LogicalType& type);
+  //! Converts the constants of the conditions to T (and sorts the IN lists)
+  template <class T>
+  unique_ptr<ArrowPrefilterConditions> ConvertConditions() const;
+
+  //! All comparisons must hold
+  vector<Comparison> comparisons;
+  //! Each IN list must contain the value
+  vector<vector<Value>> in_lists;
+  //! The conditions with constants of the C++ type of the column, which are
+  //! checked for every vector
+  unique_ptr<ArrowPrefilterConditions> conditions;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
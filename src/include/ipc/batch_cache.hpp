@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/batch_cache.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "nanoarrow/nanoarrow.hpp"
+
+#include "duckdb/common/atomic.hpp"
+#include "duckdb/common/list.hpp"
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/main/client_context.hpp"
+#include "duckdb/storage/object_cache.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Identifies one version of a file. Cached batches of a file whose modification
+//! time or size changed are never returned.
+struct ArrowBatchCacheFile {
+  //! Modification times may only have a granularity of seconds: a file that was
+  //! modified this recently may still be rewritten with the same size and
+  //! modification time, so its batches aren't cached
+  static constexpr int64_t RACY_MODIFICATION_SECONDS = 2;
+
+  string path;
+  int64_t last_modified = 0;
+  idx_t file_size = 0;
+  //! Whether the file was modified within the last RACY_MODIFICATION_SECONDS
+  bool recently_modified = false;
+};
+
+//! A decoded (and decompressed) array that is shared by the cache and all scans
+//! that were served from it. It is never modified after it was cached.
+class CachedArrowArray {
+ public:
+  CachedArrowArray(ArrowArray* array, idx_t size_bytes);
+  ~CachedArrowArray();
+
+  //! Exports a reference to the array, which keeps it alive until it is released.
+  //! The buffers and children are the ones of the cached array.
+  static void Export(shared_ptr<CachedArrowArray> cached, ArrowArray* out);
+  //! Memory used by the buffers of an array
+  static idx_t ArraySize(const ArrowSchema* schema, const ArrowArray* array);
+
+  ArrowArray array;
+  idx_t size_bytes;
+};
+
+//! Least recently used cache of decoded record batch fields, shared by all queries
+//! of a database. Entries are keyed by file path and size, file offset of the record
+//! batch message and the flattened field index (-1 for a batch decoded as a whole).
+class ArrowBatchCache : public ObjectCacheEntry {
+ public:
+  explicit ArrowBatchCache(idx_t capacity) : capacity(capacity) {}
+
+  static string ObjectType() { return "nanoarrow_batch_cache"; }
+  string GetObjectType() override { return ObjectType(); }
+
+  //! Returns the cache of the database, or nullptr if arrow_batch_cache_size is 0
+  static shared_ptr<ArrowBatchCache> Get(ClientContext& context);
+
+  shared_ptr<CachedArrowArray> Lookup(const ArrowBatchCacheFile& file,
+                                      idx_t message_offset, int64_t field);
+  void Insert(const ArrowBatchCacheFile& file, idx_t message_offset, int64_t field,
+              shared_ptr<CachedArrowArray> array);
+  //! Changes the capacity, evicting entries if the cache is now too large
+  void SetCapacity(idx_t capacity);
+  //! Whether scans use the cache. The windows of shared scans (see ArrowSharedScan)
+  //! are only used while more than one scan is running.
+  bool IsActive() const { return active; }
+  void SetActive(bool active_p) { active = active_p; }
+
+ private:
+  struct Entry {
+    string key;
+    int64_t last_modified;
+    idx_t file_size;
+    shared_ptr<CachedArrowArray> array;
+  };
+
+  static string Key(const ArrowBatchCacheFile& file, idx_t message_offset,
+                    int64_t field);
+  void Erase(list<Entry>::iterator entry);
+  void EvictToCapacity();
+
+  mutex lock;
+  atomic<bool> active{true};
+  idx_t capacity;
+  idx_t size = 0;
+  //! Most recently used entries first
+  list<Entry> entries;
+  unordered_map<string, list<Entry>::iterator> index;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/batch_coalescer.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "nanoarrow/nanoarrow.hpp"
+
+#include "duckdb/common/common.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Buffer layout of a flat (not nested, not dictionary encoded) column: a validity
+//! bitmap and either a buffer of fixed-width values (including bit-packed booleans)
+//! or the offsets and data buffers of variable-size binary values
+struct ArrowFlatLayout {
+  bool variable_size;
+  //! Bits per value, or per offset of variable-size columns
+  int64_t value_bits;
+
+  idx_t BufferCount() const { return variable_size ? 3 : 2; }
+  //! Returns false if the field isn't a flat column
+  static bool Get(const ArrowSchema& field, ArrowFlatLayout& out);
+};
+
+//! Merges consecutive record batches of flat columns into one. Streams of many
+//! tiny record batches would otherwise go through the Arrow scan one batch at a
+//! time, which costs far more than their data.
+class ArrowBatchCoalescer {
+ public:
+  //! Whether all columns of a schema are flat
+  static bool SupportsSchema(const ArrowSchema& schema);
+
+  explicit ArrowBatchCoalescer(const ArrowSchema& schema);
+
+  //! Appends the rows of a record batch. Returns false without appending anything
+  //! if they don't fit (i.e., 32-bit offsets would overflow).
+  bool Append(const ArrowArray& batch);
+  //! Number of rows appended so far
+  int64_t Length() const { return length; }
+  //! Moves the merged record batch into out
+  void Finish(ArrowArray* out);
+
+ private:
+  void AppendColumn(idx_t column_idx, const ArrowArray& column, int64_t offset,
+                    int64_t count);
+
+  nanoarrow::UniqueArray array;
+  vector<ArrowFlatLayout> layouts;
+  vector<int64_t> null_counts;
+  int64_t length = 0;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/batch_statistics.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/serializer/deserializer.hpp"
+#include "duckdb/common/serializer/serializer.hpp"
+#include "duckdb/common/serializer/write_stream.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/storage/statistics/base_statistics.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Statistics of the top-level columns of one record batch
+struct ArrowBatchStatistics {
+  //! Offset of the record batch message in the file
+  idx_t message_offset = 0;
+  idx_t row_count = 0;
+  //! Statistics of each column. Min/max are tracked for numeric and string
+  //! columns, the other columns only have unknown statistics.
+  vector<BaseStatistics> columns;
+  //! Serialized bloom filter of the values of each column (see ArrowBloomFilter),
+  //! empty for the columns that have none
+  vector<string> bloom_filters;
+
+  //! Statistics of a batch without rows
+  static ArrowBatchStatistics Create(const vector<LogicalType>& types);
+  //! Adds the rows of a chunk to the statistics
+  void Update(DataChunk& chunk);
+  //! Builds the bloom filter of a column from all of the values of the batch
+  void AddBloomFilter(idx_t column_idx, Vector& values, idx_t count);
+
+  void Serialize(Serializer& serializer) const;
+  static ArrowBatchStatistics Deserialize(Deserializer& deserializer,
+                                          const vector<LogicalType>& types);
+};
+
+//! Statistics of the record batches of a stream written with
+//! COPY ... (BATCH_STATISTICS true). They are appended after the end-of-stream
+//! marker, where other readers stop reading, as
+//! <DuckDB binary serialization><uint64 size of the serialization><"NANOSTAT">.
+struct ArrowFileStatistics {
+  static constexpr const char* TRAILER_MAGIC = "NANOSTAT";
+  static constexpr idx_t TRAILER_MAGIC_SIZE = 8;
+  static constexpr idx_t TRAILER_SIZE = sizeof(uint64_t) + TRAILER_MAGIC_SIZE;
+
+  //! Types of the columns, the statistics are ignored if the file is read with
+  //! other types
+  vector<LogicalType> types;
+  //! Statistics of each record batch, in file order
+  vector<ArrowBatchStatistics> batches;
+
+  //! Returns the statistics of the record batch at message_offset, or nullptr if
+  //! there are none
+  optional_ptr<ArrowBatchStatistics> FindBatch(idx_t message_offset);
+  //! Number of rows of all record batches
+  idx_t RowCount() const;
+  //! Statistics of a column over all record batches
+  unique_ptr<BaseStatistics> ColumnStatistics(idx_t column_idx) const;
+
+  //! Writes the statistics and the trailer that locates them
+  void Write(WriteStream& stream) const;
+  //! Deserializes statistics written by Write() (without the trailer). Returns
+  //! nullptr if they can't be read, e.g., when written by another DuckDB version.
+  static unique_ptr<ArrowFileStatistics> Read(const_data_ptr_t data, idx_t size);
+
+  void Serialize(Serializer& serializer) const;
+  static unique_ptr<ArrowFileStatistics> Deserialize(Deserializer& deserializer);
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/bloom_filter.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "duckdb/common/types/vector.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! A split block bloom filter (the layout Parquet uses): 32-byte blocks of eight
+//! 32-bit words, where every value sets one bit in each word of one block. Values
+//! are hashed with a hash of their own that doesn't change between DuckDB versions,
+//! since filters are stored in files.
+class ArrowBloomFilter {
+ public:
+  static constexpr idx_t BLOCK_SIZE = 32;
+  //! Filters are sized for this false positive rate
+  static constexpr double FALSE_POSITIVE_RATE = 0.01;
+
+  //! An empty filter sized for distinct_count values
+  explicit ArrowBloomFilter(idx_t distinct_count);
+  //! A filter read from a file
+  explicit ArrowBloomFilter(string data);
+
+  //! Whether a filter can be built for (and probed with) values of a type
+  static bool SupportsType(const LogicalType& type);
+
+  //! Adds the non-null values of a vector
+  void Insert(Vector& vector, idx_t count);
+  //! Returns false if the value was certainly not inserted
+  bool MayContain(const Value& value) const { return MayContain(data, value); }
+  //! Probes a serialized filter without copying it
+  static bool MayContain(const string& data, const Value& value);
+
+  const string& Data() const { return data; }
+
+ private:
+  void Insert(uint64_t hash);
+
+  string data;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/conversion_kernels.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "nanoarrow/nanoarrow.hpp"
+
+#include "duckdb/common/allocator.hpp"
+#include "duckdb/common/common.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Converts a top-level column whose Arrow type the Arrow scan can't read zero-copy
+//! (e.g., timezone-aware millisecond timestamps, time32 or date64) into the Arrow
+//! type that matches DuckDB's physical layout. The scan converts such columns one
+//! value at a time, a kernel converts the whole values buffer of a record batch in a
+//! loop the compiler vectorizes. The DuckDB type of the column doesn't change.
+class ArrowConversionKernel {
+ public:
+  //! Returns the kernel of a field, or nullptr if it is read zero-copy already (or
+  //! isn't supported)
+  static unique_ptr<ArrowConversionKernel> Create(const ArrowSchema& field);
+  //! Rewrites the formats of the top-level fields of a schema that have a kernel to
+  //! the formats of their converted columns. Returns true if any field has one.
+  static bool ConvertSchema(ArrowSchema& schema);
+
+  //! Replaces a record batch with one whose columns are converted by their kernel
+  //! (kernels[i] converts column i, nullptr leaves it as it is)
+  static void ConvertBatch(const vector<unique_ptr<ArrowConversionKernel>>& kernels,
+                           ArrowArray& batch, Allocator& allocator);
+  //! Returns the converted values buffer of a column (with the same offset)
+  AllocatedData Convert(const ArrowArray& column, Allocator& allocator) const;
+
+ private:
+  //! Converts count values, returns true if a multiplied value overflowed
+  using kernel_t = bool (*)(const_data_ptr_t source, data_ptr_t target, idx_t count);
+
+  ArrowConversionKernel(const char* target_format, kernel_t kernel, idx_t source_width,
+                        idx_t target_width, int64_t overflow_factor = 0)
+      : target_format(target_format),
+        kernel(kernel),
+        source_width(source_width),
+        target_width(target_width),
+        overflow_factor(overflow_factor) {}
+
+  //! Throws if a valid value overflows when multiplied by the overflow factor
+  void CheckOverflow(const ArrowArray& column) const;
+
+  //! Format of the converted column, without the timezone of timestamps
+  const char* target_format;
+  kernel_t kernel;
+  //! Bytes per value of the column and of the converted column
+  idx_t source_width;
+  idx_t target_width;
+  //! Factor of the kernels whose products can overflow, 0 for the others
+  int64_t overflow_factor;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
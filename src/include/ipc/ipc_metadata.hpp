@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/ipc_metadata.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "nanoarrow/nanoarrow.hpp"
+
+#include "duckdb/common/common.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Length and null count of one (flattened) field of a record batch
+struct IPCFieldNode {
+  int64_t length;
+  int64_t null_count;
+};
+
+//! Position of one buffer within a record batch body
+struct IPCBodyBuffer {
+  int64_t offset;
+  int64_t length;
+};
+
+//! The parts of a RecordBatch message header that the ArrowIpcDecoder does not
+//! expose (e.g., the number of rows), which lets us decide what to do with a record
+//! batch before reading its body.
+struct IPCRecordBatchHeader {
+  //! Number of rows in the batch
+  int64_t length = 0;
+  //! One node per flattened field, in depth-first order
+  vector<IPCFieldNode> nodes;
+  //! Buffers of all flattened fields, in depth-first order
+  vector<IPCBodyBuffer> buffers;
+  //! Whether the body buffers are compressed
+  bool compressed = false;
+};
+
+//! A record batch (or dictionary batch) entry of an IPC file footer
+struct IPCFileBlock {
+  int64_t offset;
+  int32_t metadata_length;
+  int64_t body_length;
+};
+
+//! Minimal readers of the flatbuffers that make up IPC message headers and file
+//! footers. Both return false if the flatbuffer is malformed or of an unexpected
+//! type, in which case callers should fall back to not using the information.
+struct IPCMetadata {
+  //! Decode the header of a RecordBatch message. The view points to the flatbuffer
+  //! (i.e., after the continuation token and metadata size).
+  static bool DecodeRecordBatchHeader(ArrowBufferView message,
+                                      IPCRecordBatchHeader& out);
+  //! Decode the record batch blocks of an IPC file footer flatbuffer
+  static bool DecodeFooterBlocks(ArrowBufferView footer, vector<IPCFileBlock>& out);
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/read_ahead_file_reader.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/allocator.hpp"
+#include "duckdb/common/file_system.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! A slice of a buffer that is kept alive by its owner
+struct ReadBufferSlice {
+  shared_ptr<AllocatedData> owner;
+  data_ptr_t ptr = nullptr;
+  idx_t size = 0;
+};
+
+//! Reads a file with large positioned reads. Instead of issuing one small read()
+//! per message piece, a read-ahead window covering the next messages is fetched
+//! in a single request and message bodies are handed out as zero-copy slices of
+//! that window. This matters most for remote file systems, where every read is a
+//! separate request.
+//!
+//! If the handle was opened with O_DIRECT, window reads start and end at
+//! DIRECT_IO_ALIGNMENT boundaries and go to aligned memory. Reads of the
+//! unaligned file tail are allowed to come back short.
+//!
+//! Sources that can't seek (e.g., pipes or /dev/stdin) are read sequentially: the
+//! window is refilled from the current offset with plain reads, the size of the
+//! source is unknown (FileSize() is 0) and only forward seeks are possible.
+class ReadAheadFileReader {
+ public:
+  static constexpr idx_t DEFAULT_READ_AHEAD_SIZE = 8 * 1024 * 1024;
+  static constexpr idx_t DIRECT_IO_ALIGNMENT = 4096;
+  //! Buffers smaller than read_ahead_size / MIN_SLICE_FRACTION are copied out of the
+  //! window, so that a small body can't keep the whole window alive
+  static constexpr idx_t MIN_SLICE_FRACTION = 8;
+
+  ReadAheadFileReader(unique_ptr<FileHandle> handle, Allocator& allocator,
+                      bool direct_io = false,
+                      idx_t read_ahead_size = DEFAULT_READ_AHEAD_SIZE);
+
+  //! Copies the next size bytes of the file into ptr
+  void ReadData(data_ptr_t ptr, idx_t size);
+  //! Returns the next size bytes of the file, slicing the read-ahead window when
+  //! the bytes are (or can be made) part of it
+  ReadBufferSlice ReadBuffer(idx_t size);
+  //! Moves the current offset forward without reading anything
+  void Skip(idx_t size);
+  //! Moves the current offset to an absolute position in the file
+  void Seek(idx_t offset);
+  //! Restricts reading to [start, end) of the file, moving the current offset to
+  //! start. The read-ahead window is kept if it holds start, but no bytes past end
+  //! are read from it.
+  void SetRange(idx_t start, idx_t end);
+  //! Reads the read-ahead window at the current offset, unless it is there already
+  void Prefetch();
+  //! Reads the last size bytes of the file into a buffer of their own, so that the
+  //! trailers and footer at the end of a file take a single request without
+  //! replacing the read-ahead window. Does nothing if they were read already. The
+  //! current offset doesn't change.
+  void PrefetchTail(idx_t size);
+
+  FileHandle& GetHandle() { return *handle; }
+  idx_t CurrentOffset() const { return offset; }
+  //! The size of the file, 0 if it can't seek
+  idx_t FileSize() const { return file_size; }
+  //! Whether the file can be read at any offset (otherwise it is read sequentially)
+  bool IsSeekable() const { return seekable; }
+  //! Returns true if fewer than size bytes are left in the file (or range). Sources
+  //! that can't seek are read up to offset + size to find out.
+  bool Exhausted(idx_t size = 1);
+
+ private:
+  //! Makes sure [offset, offset + size) is in the read-ahead window
+  void FillWindow(idx_t size);
+  //! FillWindow() of sources that can't seek, which may end before offset + size
+  void FillSequentialWindow(idx_t size);
+  //! Reads [start, end) of the file into ptr, which must be aligned for direct I/O
+  void ReadRange(data_ptr_t ptr, idx_t start, idx_t end);
+  //! Reads [start, end) of the file into a new allocation, returning its first byte
+  data_ptr_t ReadBlock(idx_t start, idx_t end, shared_ptr<AllocatedData>& data);
+  bool InWindow(idx_t size) const;
+  bool InTail(idx_t size) const;
+  void CheckAvailable(idx_t size);
+
+  unique_ptr<FileHandle> handle;
+  Allocator& allocator;
+  bool seekable;
+  bool direct_io;
+  idx_t read_ahead_size;
+  idx_t file_size;
+  idx_t offset{0};
+  //! End of the readable range, which is the end of the file unless restricted
+  idx_t read_end;
+
+  //! The read-ahead window and the file offset of its first byte
+  shared_ptr<AllocatedData> window;
+  data_ptr_t window_ptr{};
+  idx_t window_start{0};
+  idx_t window_size{0};
+
+  //! The end of the file read by PrefetchTail() and the file offset of its first byte
+  shared_ptr<AllocatedData> tail;
+  data_ptr_t tail_ptr{};
+  idx_t tail_start{0};
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
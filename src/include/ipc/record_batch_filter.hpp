@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/record_batch_filter.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/optional_idx.hpp"
+#include "duckdb/common/random_engine.hpp"
+
+#include "ipc/ipc_metadata.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Decides, based on the header of a record batch, whether the batch is needed.
+//! The body of a skipped batch is never read (the reader seeks over it).
+class RecordBatchFilter {
+ public:
+  virtual ~RecordBatchFilter() = default;
+  //! Returns true if the batch can be skipped. batch_index counts all record
+  //! batches in the stream (including skipped ones). message_offset is the offset
+  //! of the message in the file, if the stream is read from a file. header is
+  //! nullptr if the message header could not be decoded.
+  virtual bool SkipBatch(idx_t batch_index, optional_idx message_offset,
+                         const IPCRecordBatchHeader* header) = 0;
+};
+
+//! Keeps each record batch with a fixed probability (batch-granular SYSTEM sampling)
+class SampleBatchFilter : public RecordBatchFilter {
+ public:
+  SampleBatchFilter(double percentage, int64_t seed)
+      : probability(percentage / 100.0), random(seed) {}
+
+  bool SkipBatch(idx_t batch_index, optional_idx message_offset,
+                 const IPCRecordBatchHeader* header) override {
+    return random.NextRandom() >= probability;
+  }
+
+ private:
+  double probability;
+  RandomEngine random;
+};
+
+//! Skips every record batch after adding up the number of rows in its header
+class RowCountFilter : public RecordBatchFilter {
+ public:
+  bool SkipBatch(idx_t batch_index, optional_idx message_offset,
+                 const IPCRecordBatchHeader* header) override {
+    if (!header || header->length < 0) {
+      valid = false;
+    } else {
+      row_count += static_cast<idx_t>(header->length);
+    }
+    batch_count++;
+    return true;
+  }
+
+  idx_t row_count = 0;
+  idx_t batch_count = 0;
+  //! False if the header of a batch could not be decoded
+  bool valid = true;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/schema_index.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "nanoarrow/nanoarrow.hpp"
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/unordered_map.hpp"
+#include "duckdb/common/unordered_set.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Where the columns of a schema are found in its record batches. Record batches
+//! list the nodes and buffers of all (flattened) fields, so this takes a walk over
+//! the whole schema, which is done once per schema and shared by all readers of
+//! files with that schema. Per-batch and per-file work then only depends on the
+//! projected columns, even for schemas with thousands of fields.
+struct IPCSchemaIndex {
+  explicit IPCSchemaIndex(const ArrowSchema& schema);
+
+  //! Returns the top-level column with the (deduplicated) name. Throws if there is
+  //! none, or if the name is ambiguous.
+  idx_t GetColumn(const string& name) const;
+
+  //! Deduplicated names of the top-level columns
+  vector<string> names;
+  //! Index of each top-level column in the flattened fields, which is its node
+  //! index in record batches
+  vector<int64_t> column_fields;
+  //! Index of the first buffer of each flattened field in record batches, empty if
+  //! the buffers depend on the batch (i.e., the variadic buffers of view types)
+  vector<int64_t> field_buffers;
+  //! Number of buffers of a record batch (if field_buffers is not empty)
+  int64_t buffer_count = 0;
+
+ private:
+  unordered_map<string, idx_t> columns;
+  //! Duplicate column names are fine as long as they are not queried
+  unordered_set<string> duplicate_names;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,37 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/shared_memory.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "duckdb/common/common.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! A read-only mapping of a POSIX shared memory object into which another process
+//! wrote an Arrow IPC stream. Scans read the
+//! record batches in place, so the mapping must outlive them.
+class SharedMemoryMapping {
+ public:
+  //! Maps the shared memory object with this name (as passed to shm_open())
+  static unique_ptr<SharedMemoryMapping> OpenName(const string& name);
+  ~SharedMemoryMapping();
+
+  data_ptr_t Data() const { return data; }
+  idx_t Size() const { return size; }
+
+ private:
+  SharedMemoryMapping(data_ptr_t data, idx_t size) : data(data), size(size) {}
+  static unique_ptr<SharedMemoryMapping> Map(int fd, const string& description);
+
+  data_ptr_t data;
+  idx_t size;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
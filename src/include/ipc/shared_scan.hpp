@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/shared_scan.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "ipc/batch_cache.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! The scans of one version of a file that are running at the same time (e.g.,
+//! dashboard queries that all start at once). While more than one of them runs, the
+//! record batches they decode go into a small window of recently decoded batches,
+//! which every scan looks up before reading and decoding a batch itself.
+class ArrowSharedScan {
+ public:
+  explicit ArrowSharedScan(ArrowBatchCacheFile file);
+
+  //! Recently decoded record batches of the file, shared by refcount
+  const shared_ptr<ArrowBatchCache> window;
+
+  //! Records that one of the scans started reading the scan unit at offset
+  void StartUnit(idx_t offset);
+  //! Offset of the scan unit that was started last, if any
+  optional_idx LatestUnit();
+
+ private:
+  friend class ArrowSharedScans;
+
+  const ArrowBatchCacheFile file;
+  mutex lock;
+  idx_t scan_count = 0;
+  optional_idx latest_unit;
+};
+
+class ArrowSharedScans;
+
+//! Registration of one scan, which is removed when the handle is destroyed
+class ArrowSharedScanHandle {
+ public:
+  ArrowSharedScanHandle(shared_ptr<ArrowSharedScans> registry,
+                        shared_ptr<ArrowSharedScan> scan);
+  ~ArrowSharedScanHandle();
+
+  ArrowSharedScan& Get() { return *scan; }
+
+ private:
+  shared_ptr<ArrowSharedScans> registry;
+  shared_ptr<ArrowSharedScan> scan;
+};
+
+//! The running scans of the files of a database. The windows of all files that are
+//! scanned concurrently share the memory of arrow_shared_scan_window.
+class ArrowSharedScans : public ObjectCacheEntry {
+ public:
+  static string ObjectType() { return "nanoarrow_shared_scans"; }
+  string GetObjectType() override { return ObjectType(); }
+
+  //! Memory of the windows of all shared scans, 0 if scans aren't shared
+  static idx_t WindowBudget(ClientContext& context);
+  //! Registers a scan of a file, whose windows share window_budget
+  static unique_ptr<ArrowSharedScanHandle> Register(ClientContext& context,
+                                                    const ArrowBatchCacheFile& file,
+                                                    idx_t window_budget);
+
+ private:
+  friend class ArrowSharedScanHandle;
+
+  void Unregister(ArrowSharedScan& scan);
+  //! Batches are only added to the window while other scans can use them
+  void UpdateWindow(ArrowSharedScan& scan);
+  //! Divides the budget between the windows in use
+  void ResizeWindows();
+
+  mutex lock;
+  idx_t window_budget = 0;
+  //! The running scans of each file path
+  unordered_map<string, shared_ptr<ArrowSharedScan>> scans;
+  //! Scans whose window is in use (i.e., more than one scan of the file is running).
+  //! A scan leaves this list before its last handle is destroyed.
+  vector<reference<ArrowSharedScan>> active_scans;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,43 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/sort_order.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "nanoarrow/nanoarrow.hpp"
+
+#include "duckdb/common/common.hpp"
+#include "duckdb/common/enums/order_type.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! One column of the order the rows of a file are sorted in
+struct ArrowSortKey {
+  string column;
+  OrderType type;
+  OrderByNullType null_order;
+};
+
+//! The sort order of a file is declared in its schema metadata as a SQL ORDER BY
+//! list of column names, e.g., "tenant_id ASC NULLS LAST, ts ASC NULLS LAST".
+//! Rows are compared like DuckDB compares them without a collation.
+struct ArrowSortOrder {
+  static constexpr const char* METADATA_KEY = "duckdb:sort_order";
+
+  //! Parses an ORDER BY list of column names. Directions that are not given are
+  //! ASC and NULLS LAST. Throws if the list is not valid.
+  static vector<ArrowSortKey> Parse(const string& order_list);
+  //! Formats the sort keys with all directions spelled out
+  static string ToString(const vector<ArrowSortKey>& keys);
+  //! Reads the sort order from the metadata of a schema. Returns no keys if the
+  //! schema declares none or the declaration can't be parsed.
+  static vector<ArrowSortKey> FromSchema(const ArrowSchema& schema);
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "ipc/array_stream.hpp"
+#include "ipc/shared_memory.hpp"
 
 #include "duckdb/common/arrow/arrow_wrapper.hpp"
 #include "duckdb/function/table/arrow.hpp"
@@ -57,11 +58,38 @@ class BufferIPCStreamFactory final : public ArrowIPCStreamFactory {
 
 class FileIPCStreamFactory final : public ArrowIPCStreamFactory {
  public:
-  explicit FileIPCStreamFactory(ClientContext& context, string src_string);
+  explicit FileIPCStreamFactory(ClientContext& context, string src_string,
+                                bool direct_io = false);
   void InitReader() override;
 
   FileSystem& fs;
   string src_string;
+  //! Whether the file is read with O_DIRECT, bypassing the page cache
+  bool direct_io;
+};
+
+//! Reads a stream that a peer sends over a Unix domain socket or TCP connection
+class SocketIPCStreamFactory final : public ArrowIPCStreamFactory {
+ public:
+  SocketIPCStreamFactory(ClientContext& context, string address);
+  void InitReader() override;
+
+  //! The scan stops waiting for the peer when a query of the context is interrupted
+  ClientContext& context;
+  //! unix://path or tcp://host:port
+  string address;
+};
+
+//! Reads a stream in place from a shared memory object mapped into memory. The factory
+//! lives as long as the bind data, which keeps the mapping (and the record batches
+//! that point into it) valid for the whole query.
+class SharedMemoryIPCStreamFactory final : public ArrowIPCStreamFactory {
+ public:
+  SharedMemoryIPCStreamFactory(ClientContext& context,
+                               unique_ptr<SharedMemoryMapping> mapping);
+  void InitReader() override;
+
+  unique_ptr<SharedMemoryMapping> mapping;
 };
 }  // namespace ext_nanoarrow
 }  // namespace duckdb
@@ -15,6 +15,11 @@
 #include "duckdb/common/file_system.hpp"
 #include "duckdb/common/radix.hpp"
 #include "duckdb/common/serializer/buffered_file_reader.hpp"
+#include "ipc/batch_cache.hpp"
+#include "ipc/batch_coalescer.hpp"
+#include "ipc/conversion_kernels.hpp"
+#include "ipc/record_batch_filter.hpp"
+#include "ipc/schema_index.hpp"
 #include "nanoarrow_errors.hpp"
 
 #include "table_function/scan_arrow_ipc.hpp"
@@ -47,8 +52,16 @@ class IPCStreamReader {
   //! Gets the output schema, which is the file schema with projection pushdown being
   //! considered
   const ArrowSchema* GetOutputSchema();
+  //! Record batches with fewer rows are merged with the batches that follow them
+  //! (if all output columns are flat), so that the Arrow scan converts full vectors
+  static constexpr int64_t COALESCE_ROWS = STANDARD_VECTOR_SIZE;
+
   //! Gets the next batch
   bool GetNextBatch(ArrowArray* out);
+  //! Converts the columns that have an ArrowConversionKernel in the batches that
+  //! GetNextBatch() returns. Their schema is then the output schema rewritten by
+  //! ArrowConversionKernel::ConvertSchema().
+  void EnableConversionKernels() { convert_columns = true; }
   //! Gets the unique buffer to get the next batch
   virtual nanoarrow::UniqueBuffer GetUniqueBuffer() {
     throw InternalException("IPCStreamReader::GetUniqueBuffer not implemented");
@@ -58,6 +71,36 @@ class IPCStreamReader {
   void SetColumnProjection(const vector<string>& column_names);
   //! Gets the base schema with no projection pushdown
   const ArrowSchema* GetBaseSchema();
+  //! Gets the schema message (prefix and flatbuffer) as it was read from the
+  //! stream. Streams with identical schema messages have identical schemas.
+  const string& GetSchemaMessage() {
+    GetBaseSchema();
+    return schema_message;
+  }
+  //! Uses a schema that was already read from the same file (e.g., by another reader
+  //! of the file), for readers that start in the middle of the file
+  void SetBaseSchema(const ArrowSchema* schema);
+  //! Gets the index of the columns of the base schema, building it if no reader of
+  //! the schema did so before
+  const IPCSchemaIndex& GetSchemaIndex();
+  shared_ptr<IPCSchemaIndex> GetSharedSchemaIndex() {
+    GetSchemaIndex();
+    return schema_index;
+  }
+  //! Uses the index of another reader of the same schema
+  void SetSchemaIndex(shared_ptr<IPCSchemaIndex> index);
+
+  //! Adds a filter that can skip record batches based on their header
+  void AddBatchFilter(unique_ptr<RecordBatchFilter> filter);
+  //! Stops reading once this many rows have been returned, slicing the last batch
+  void SetRowLimit(idx_t limit) { row_limit = limit; }
+
+  //! Serves decoded record batches from the cache and adds the batches it has to
+  //! decode to it, counting the batches that were served into cached_batches. Only
+  //! readers that know the file offset of their messages (i.e., file readers) use
+  //! the cache.
+  void SetBatchCache(shared_ptr<ArrowBatchCache> cache, ArrowBatchCacheFile file,
+                     optional_ptr<atomic<idx_t>> cached_batches = nullptr);
 
   ArrowIpcMessageType ReadNextMessage(vector<ArrowIpcMessageType> expected_types,
                                       bool end_of_stream_ok = true);
@@ -81,6 +124,34 @@ class IPCStreamReader {
   virtual void DecodeBody() {
     throw InternalException("IPCStreamReader::DecodeBody not implemented");
   }
+  //! 3b. Or we move past the message body without reading it
+  virtual void SkipBody() {
+    throw InternalException("IPCStreamReader::SkipBody not implemented");
+  }
+  //! Returns the next row slice of a record batch that the reader decided to read
+  //! in slices (instead of reading its whole body), false if there is none
+  virtual bool NextBatchSlice(ArrowArray* out) { return false; }
+  //! Reads the next record batch of the stream (or slice of one)
+  bool ReadNextBatch(ArrowArray* out);
+  //! Reads the next record batch, merged with the small batches that follow it
+  bool ReadMergedBatch(ArrowArray* out);
+  //! Whether small record batches of the output schema can be merged
+  bool CanCoalesce();
+  //! Applies the conversion kernels of the output schema to a record batch
+  void ConvertColumns(ArrowArray& batch);
+  //! Sets up the decoder to decode record batches of the base schema
+  void InitializeDecoder();
+  //! Checks the batch filters against the record batch whose header was just decoded
+  bool SkipCurrentBatch();
+  //! Looks up the fields of the current record batch in the batch cache, returns
+  //! true if all of them were found
+  bool LookupCachedBatch();
+  //! Builds the output array of the current record batch from the cached fields
+  void ExportCachedBatch(ArrowArray* out);
+  //! Moves the decoded output array of the current record batch into the cache
+  void CacheBatch(nanoarrow::UniqueArray& array);
+  //! Slices the output array if it would exceed the row limit
+  void ApplyRowLimit(ArrowArray* array);
 
   bool HasProjection() const;
   static nanoarrow::ipc::UniqueDecoder NewDuckDBArrowDecoder();
@@ -91,18 +162,53 @@ class IPCStreamReader {
 
   static const char* MessageTypeString(ArrowIpcMessageType message_type);
 
-  static int64_t CountFields(const ArrowSchema* schema);
-
   ArrowError error{};
   nanoarrow::ipc::UniqueDecoder decoder{};
   vector<int64_t> projected_fields;
   nanoarrow::UniqueSchema projected_schema;
   //! Schema without projection applied to it
   nanoarrow::UniqueSchema base_schema;
+  //! The schema message the base schema was decoded from (empty if it was set)
+  string schema_message;
+  //! Index of the columns of the base schema, shared with other readers
+  shared_ptr<IPCSchemaIndex> schema_index;
 
   //! Information on current buffer
   data_ptr_t cur_ptr{};
   int64_t cur_size{};
+  //! The current message header (including the message prefix), set by DecodeHeader
+  ArrowBufferView header_view{};
+
+  //! Filters that may skip record batches before their body is read
+  vector<unique_ptr<RecordBatchFilter>> batch_filters;
+  //! Number of record batches seen so far (including skipped ones)
+  idx_t batch_count{0};
+  //! Whether the body of the last message was skipped
+  bool body_skipped{false};
+  //! File offset of the current message, if the reader knows it
+  optional_idx message_offset;
+
+  //! Cache of decoded record batches and the identity of the file being read
+  shared_ptr<ArrowBatchCache> batch_cache;
+  ArrowBatchCacheFile batch_cache_file;
+  optional_ptr<atomic<idx_t>> cached_batch_count;
+  //! Cached fields of the current record batch, if it was found in the cache
+  vector<shared_ptr<CachedArrowArray>> cached_fields;
+  //! A record batch that was read while merging small batches, but was too large to
+  //! be merged. It is returned next.
+  nanoarrow::UniqueArray pending_batch;
+  //! Whether CanCoalesce() was computed for the output schema, and its result
+  bool coalesce_checked{false};
+  bool coalesce_supported{false};
+  //! Whether the columns of returned batches are converted, and the conversion
+  //! kernel of each column of the output schema (once computed)
+  bool convert_columns{false};
+  bool conversion_checked{false};
+  bool has_conversion_kernels{false};
+  vector<unique_ptr<ArrowConversionKernel>> conversion_kernels;
+  //! Maximum number of rows to return and the number of rows returned so far
+  optional_idx row_limit;
+  idx_t rows_returned{0};
 
   //! Allocator used to allocate buffers with decoded arrow information
   Allocator& allocator;
@@ -25,11 +25,15 @@ class IPCBufferStreamReader final : public IPCStreamReader {
   IPCBufferStreamReader(vector<ArrowIPCBuffer> buffers, Allocator& allocator);
 
   ArrowIpcMessageType ReadNextMessage() override;
+  //! Continues with the record batches of other buffers, which use the schema that
+  //! was already read (or set)
+  void SetBuffers(vector<ArrowIPCBuffer> buffers);
 
  private:
   data_ptr_t ReadData(data_ptr_t ptr, idx_t size) override;
   bool DecodeHeader(idx_t message_header_size) override;
   void DecodeBody() override;
+  void SkipBody() override;
   nanoarrow::UniqueBuffer GetUniqueBuffer() override;
   vector<ArrowIPCBuffer> buffers;
   idx_t cur_idx = 0;
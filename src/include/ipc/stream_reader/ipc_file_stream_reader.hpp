@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include "ipc/batch_coalescer.hpp"
+#include "ipc/batch_statistics.hpp"
+#include "ipc/ipc_metadata.hpp"
+#include "ipc/read_ahead_file_reader.hpp"
 #include "ipc/stream_reader/base_stream_reader.hpp"
 
 namespace duckdb {
@@ -16,25 +20,111 @@ namespace ext_nanoarrow {
 //! IPC File
 class IPCFileStreamReader final : public IPCStreamReader {
  public:
-  IPCFileStreamReader(FileSystem& fs, unique_ptr<FileHandle> handle,
-                      Allocator& allocator);
+  IPCFileStreamReader(
+      unique_ptr<FileHandle> handle, Allocator& allocator, bool direct_io = false,
+      idx_t read_ahead_size = ReadAheadFileReader::DEFAULT_READ_AHEAD_SIZE);
+
+  //! Bodies of at least this size are not read at once but in slices of rows, if
+  //! they aren't compressed and all output columns are flat (see NextBatchSlice).
+  //! Scans take it from the arrow_sliced_batch_size setting.
+  static constexpr idx_t SLICED_BODY_SIZE = 64 * 1024 * 1024;
+  //! Approximate size of the buffers read for one slice
+  static constexpr idx_t SLICE_SIZE = 8 * 1024 * 1024;
+  //! Bytes read from the end of the file for its footer and statistics, which then
+  //! usually take one request together
+  static constexpr idx_t TAIL_READ_SIZE = 64 * 1024;
 
   ArrowIpcMessageType ReadNextMessage() override;
 
+  //! Reads bodies of at least size bytes in slices of rows (none if size is 0), and
+  //! counts the record batches that are read in slices into sliced_batches
+  void SetSlicedBodySize(idx_t size, optional_ptr<atomic<idx_t>> sliced_batches) {
+    sliced_body_size = size;
+    sliced_batch_count = sliced_batches;
+  }
+
   double GetProgress();
 
+  //! Reads the record batch blocks listed in the footer of an IPC file. Returns
+  //! false if this is a stream (i.e., there is no footer) or the footer can't be
+  //! decoded.
+  bool ReadFooterBlocks(vector<IPCFileBlock>& blocks);
+  //! Reads the record batch statistics appended to the file by
+  //! COPY ... (BATCH_STATISTICS true). Returns nullptr if there are none.
+  unique_ptr<ArrowFileStatistics> ReadStatistics();
+  //! Counts the rows of the file from the headers of its record batches, without
+  //! reading their bodies. After max_batches batches, the rest of the file is
+  //! extrapolated from the rows per byte so far (and exact is set to false). IPC
+  //! files are counted with CountFooterRows(). Returns false if a header could not
+  //! be decoded.
+  bool CountRows(idx_t max_batches, idx_t& row_count, bool& exact);
+  //! Counts the rows of an IPC file from the header of its first record batch and
+  //! the sizes of the others in the footer, without moving the current offset (so
+  //! a reader that is about to be scanned can be counted too). Returns false if
+  //! there is no footer or the header could not be decoded.
+  bool CountFooterRows(idx_t& row_count, bool& exact);
+  //! Reads the row count from the header of a record batch listed in the footer,
+  //! without moving the current offset. Returns false if it can't be decoded.
+  bool ReadBlockRowCount(const IPCFileBlock& block, idx_t& row_count);
+  //! Identifies this version of the file in a batch cache
+  ArrowBatchCacheFile GetCacheFile();
+  //! Reads the record batches that follow the current offset (e.g., after the
+  //! schema) ahead, so that the scan doesn't wait for its first read
+  void Prefetch() { file_reader.Prefetch(); }
+  //! Whether the file can be read at any offset, otherwise it is read once from start
+  //! to end (e.g., a pipe) and must not be opened again
+  bool IsSeekable() const { return file_reader.IsSeekable(); }
+  //! Only reads the messages in [start, end) of the file. The schema must have been
+  //! read (or set) before, and start must be the offset of a message.
+  void SetReadRange(idx_t start, idx_t end);
+
  private:
-  BufferedFileReader file_reader;
+  ReadAheadFileReader file_reader;
+  //! Whether the file starts with the IPC file format magic bytes
+  bool has_file_magic{false};
   AllocatedData message_header;
-  shared_ptr<AllocatedData> message_body;
+  ReadBufferSlice message_body;
+
+  //! An output column of a record batch that is read in slices
+  struct SlicedColumn {
+    IPCFieldNode node;
+    ArrowFlatLayout layout;
+    //! The validity buffer, then the values buffer (or the offsets and data
+    //! buffers of variable-size binary columns)
+    vector<IPCBodyBuffer> buffers;
+  };
+  //! A record batch whose body is read in slices of rows
+  struct SlicedBatch {
+    //! File offset of the body
+    idx_t body_start;
+    int64_t length;
+    int64_t next_row;
+    //! A multiple of STANDARD_VECTOR_SIZE, so that slices start at a byte of the
+    //! validity bitmaps
+    int64_t rows_per_slice;
+    vector<SlicedColumn> columns;
+  };
+  unique_ptr<SlicedBatch> sliced_batch;
+  idx_t sliced_body_size = SLICED_BODY_SIZE;
+  optional_ptr<atomic<idx_t>> sliced_batch_count;
 
-  void EnsureInputStreamAligned();
+  //! Skips the padding up to the next 8-byte boundary, returns false if the
+  //! file ends before that boundary
+  bool EnsureInputStreamAligned();
+  //! Sets up reading the current record batch in slices, returns false if its
+  //! body has to be read as a whole
+  bool StartSlicedBatch();
+  bool NextBatchSlice(ArrowArray* out) override;
+  //! Reads [start, end) of a body buffer of the sliced batch
+  shared_ptr<AllocatedData> ReadSliceRange(const IPCBodyBuffer& buffer, int64_t start,
+                                           int64_t end);
 
   data_ptr_t ReadData(data_ptr_t ptr, idx_t size) override;
   static void DecodeArray(nanoarrow::ipc::UniqueDecoder& decoder, ArrowArray* out,
                           ArrowBufferView& body_view, ArrowError* error);
   bool DecodeHeader(idx_t message_header_size) override;
   void DecodeBody() override;
+  void SkipBody() override;
   nanoarrow::UniqueBuffer GetUniqueBuffer() override;
   void PopulateNames(vector<string>& names);
 };
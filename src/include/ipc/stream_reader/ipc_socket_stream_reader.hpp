@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// ipc/stream_reader/ipc_socket_stream_reader.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+#include "ipc/stream_reader/base_stream_reader.hpp"
+
+#include "duckdb/common/mutex.hpp"
+#include "duckdb/main/client_context.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Reads an IPC stream from a Unix domain socket (unix://path) or a TCP connection
+//! (tcp://host:port), as the peer sends it. A background thread receives the stream
+//! into a bounded queue of blocks while the scan decodes the messages received
+//! before, so that socket reads overlap decoding.
+class IPCSocketStreamReader final : public IPCStreamReader {
+ public:
+  //! Size of the blocks the stream is received into
+  static constexpr idx_t RECEIVE_BLOCK_SIZE = 1024 * 1024;
+  //! Receiving pauses while this many received bytes wait to be decoded
+  static constexpr idx_t MAX_RECEIVED_SIZE = 64 * 1024 * 1024;
+  //! How often a scan waiting for the peer checks whether the query was interrupted
+  static constexpr int64_t INTERRUPT_CHECK_MS = 100;
+
+  //! Connects to the peer and starts receiving the stream
+  IPCSocketStreamReader(ClientContext& context, string address, Allocator& allocator);
+  ~IPCSocketStreamReader() override;
+
+  //! Whether a source of read_arrow is a socket address instead of a file
+  static bool IsSocketAddress(const string& source);
+
+  ArrowIpcMessageType ReadNextMessage() override;
+
+ private:
+  struct ReceivedBlock {
+    AllocatedData data;
+    idx_t size;
+  };
+
+  data_ptr_t ReadData(data_ptr_t ptr, idx_t size) override;
+  bool DecodeHeader(idx_t message_header_size) override;
+  void DecodeBody() override;
+  void SkipBody() override;
+  nanoarrow::UniqueBuffer GetUniqueBuffer() override;
+
+  //! Copies the next size bytes of the stream into ptr (or discards them if ptr is
+  //! nullptr). Returns false if the stream ended before the first of them, and
+  //! throws if it ended after.
+  bool Receive(data_ptr_t ptr, idx_t size);
+  //! Skips the padding up to the next 8-byte boundary of the stream
+  bool SkipPadding();
+  //! Body of the background thread
+  void ReceiveBlocks();
+
+  ClientContext& context;
+  string address;
+  int socket_fd = -1;
+  std::thread receiver;
+
+  //! Protects the received blocks and the state of the receiver
+  mutex lock;
+  //! Signaled when a block was received (or the stream ended)
+  std::condition_variable block_received;
+  //! Signaled when a block was decoded (or the reader is destroyed)
+  std::condition_variable block_consumed;
+  std::deque<ReceivedBlock> blocks;
+  //! Received bytes in the queue
+  idx_t received_size = 0;
+  bool end_of_stream = false;
+  bool stopping = false;
+  string receive_error;
+
+  //! Read position in the first block and in the whole stream
+  idx_t block_offset = 0;
+  idx_t stream_offset = 0;
+
+  AllocatedData message_header;
+  shared_ptr<AllocatedData> message_body;
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -18,5 +18,8 @@ TableFunction ReadArrowStreamFunction();
 
 void RegisterReadArrowStream(DatabaseInstance& db);
 
+//! read_arrow_socket(), which read_arrow() is replaced with for socket addresses
+void RegisterReadArrowSocket(DatabaseInstance& db);
+
 }  // namespace ext_nanoarrow
 }  // namespace duckdb
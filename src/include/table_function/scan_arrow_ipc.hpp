@@ -28,5 +28,9 @@ struct ArrowIPCBuffer {
 struct ScanArrowIPC {
   static void RegisterReadArrowStream(DatabaseInstance& db);
 };
+
+//! from_arrow_ipc(), which decodes a table of IPC messages (e.g., the output of
+//! to_arrow_ipc() stored in a table or a Parquet file)
+void RegisterFromArrowIPC(DatabaseInstance& db);
 }  // namespace ext_nanoarrow
 }  // namespace duckdb
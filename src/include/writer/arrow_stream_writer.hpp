@@ -9,6 +9,7 @@
 #pragma once
 #include "duckdb/main/client_context.hpp"
 #include "writer/column_data_collection_serializer.hpp"
+#include "writer/direct_file_writer.hpp"
 
 namespace duckdb {
 namespace ext_nanoarrow {
@@ -17,13 +18,15 @@ struct ArrowStreamWriter {
   ArrowStreamWriter(ClientContext& context, FileSystem& fs, const string& file_path,
                     const vector<LogicalType>& logical_types,
                     const vector<string>& column_names,
-                    const vector<pair<string, string>>& metadata);
+                    const vector<pair<string, string>>& metadata,
+                    bool direct_io = false, bool batch_statistics = false,
+                    vector<idx_t> bloom_filter_columns = {});
 
   void InitSchema(const vector<LogicalType>& logical_types,
                   const vector<string>& column_names,
                   const vector<pair<string, string>>& metadata);
 
-  void InitOutputFile(FileSystem& fs, const string& file_path);
+  void InitOutputFile(FileSystem& fs, const string& file_path, bool direct_io);
 
   void WriteSchema();
 
@@ -40,14 +43,24 @@ struct ArrowStreamWriter {
   idx_t FileSize() const;
 
  private:
+  //! The stream we are writing to, either the buffered or the direct writer
+  WriteStream& Output() const;
+  //! Keeps the statistics of the batch the serializer is about to flush
+  void AddBatchStatistics(ColumnDataCollectionSerializer& serializer);
+
   ClientProperties options;
   Allocator& allocator;
   ColumnDataCollectionSerializer serializer;
   string file_name;
   vector<LogicalType> logical_types;
   unique_ptr<BufferedFileWriter> writer;
+  unique_ptr<DirectFileWriter> direct_writer;
   idx_t row_group_count{0};
   nanoarrow::UniqueSchema schema;
+  //! Statistics of the written batches, appended to the file by Finalize()
+  unique_ptr<ArrowFileStatistics> statistics;
+  //! Columns whose statistics include a bloom filter
+  vector<idx_t> bloom_filter_columns;
 };
 
 }  // namespace ext_nanoarrow
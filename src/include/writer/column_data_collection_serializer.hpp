@@ -13,6 +13,7 @@
 #include "duckdb/common/types/column/column_data_collection.hpp"
 #include "duckdb/function/table/arrow/arrow_duck_schema.hpp"
 #include "duckdb/main/client_properties.hpp"
+#include "ipc/batch_statistics.hpp"
 #include "nanoarrow/nanoarrow_ipc.hpp"
 #include "nanoarrow_errors.hpp"
 
@@ -32,16 +33,32 @@ class ColumnDataCollectionSerializer {
 
   idx_t Serialize(const ColumnDataCollection& buffer);
 
-  void Flush(BufferedFileWriter& writer);
+  void Flush(WriteStream& writer);
 
   nanoarrow::UniqueBuffer GetHeader();
 
   nanoarrow::UniqueBuffer GetBody();
 
+  //! Collect the statistics of each serialized DataChunk, with bloom filters of
+  //! the given columns
+  void CollectStatistics(vector<idx_t> bloom_filter_columns_p = {}) {
+    collect_statistics = true;
+    bloom_filter_columns = std::move(bloom_filter_columns_p);
+  }
+  //! Statistics of the last serialized batch, nullptr if they were not collected
+  optional_ptr<ArrowBatchStatistics> GetStatistics() {
+    return has_statistics ? &statistics : nullptr;
+  }
+
  private:
   ClientProperties options;
   Allocator& allocator;
   const ArrowSchema* schema{};
+  vector<LogicalType> logical_types;
+  bool collect_statistics{false};
+  bool has_statistics{false};
+  vector<idx_t> bloom_filter_columns;
+  ArrowBatchStatistics statistics;
   unordered_map<idx_t, const shared_ptr<ArrowTypeExtensionData>> extension_types;
   nanoarrow::ipc::UniqueEncoder encoder;
   nanoarrow::UniqueArrayView chunk_view;
@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//                         DuckDB - nanoarrow
+//
+// writer/direct_file_writer.hpp
+//
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "duckdb/common/allocator.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/common/serializer/write_stream.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Writes a file with O_DIRECT, bypassing the page cache. Data is collected in an
+//! aligned buffer and written in whole blocks. The last (partial) block is padded
+//! with zeroes and the file is truncated to the number of bytes written on Close().
+class DirectFileWriter : public WriteStream {
+ public:
+  static constexpr idx_t BLOCK_SIZE = 4096;
+  static constexpr idx_t BUFFER_SIZE = 256 * BLOCK_SIZE;
+
+  DirectFileWriter(FileSystem& fs, const string& path, Allocator& allocator);
+
+  void WriteData(const_data_ptr_t buffer, idx_t write_size) override;
+
+  idx_t GetTotalWritten() const { return total_written; }
+
+  void Close();
+
+ private:
+  //! Writes the first size bytes of the buffer, size must be a multiple of BLOCK_SIZE
+  void FlushBuffer(idx_t size);
+
+  unique_ptr<FileHandle> handle;
+  AllocatedData allocation;
+  data_ptr_t buffer;
+  idx_t buffer_offset{0};
+  idx_t file_offset{0};
+  idx_t total_written{0};
+};
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,139 @@
+#include "ipc/batch_cache.hpp"
+
+#include "duckdb/main/config.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+void ReleaseCachedArrayReference(ArrowArray* array) {
+  delete static_cast<shared_ptr<CachedArrowArray>*>(array->private_data);
+  array->release = nullptr;
+}
+
+idx_t ArrayViewSize(const ArrowArrayView* view) {
+  idx_t size = 0;
+  for (const auto& buffer_view : view->buffer_views) {
+    size += static_cast<idx_t>(MaxValue<int64_t>(buffer_view.size_bytes, 0));
+  }
+  for (int32_t i = 0; i < view->n_variadic_buffers; i++) {
+    size += static_cast<idx_t>(view->variadic_buffer_sizes[i]);
+  }
+  for (int64_t i = 0; i < view->n_children; i++) {
+    size += ArrayViewSize(view->children[i]);
+  }
+  if (view->dictionary) {
+    size += ArrayViewSize(view->dictionary);
+  }
+  return size;
+}
+
+}  // namespace
+
+CachedArrowArray::CachedArrowArray(ArrowArray* array_p, idx_t size_bytes)
+    : size_bytes(size_bytes) {
+  ArrowArrayMove(array_p, &array);
+}
+
+CachedArrowArray::~CachedArrowArray() {
+  if (array.release) {
+    array.release(&array);
+  }
+}
+
+void CachedArrowArray::Export(shared_ptr<CachedArrowArray> cached, ArrowArray* out) {
+  *out = cached->array;
+  out->private_data = new shared_ptr<CachedArrowArray>(std::move(cached));
+  out->release = ReleaseCachedArrayReference;
+}
+
+idx_t CachedArrowArray::ArraySize(const ArrowSchema* schema, const ArrowArray* array) {
+  nanoarrow::UniqueArrayView view;
+  ArrowError error;
+  if (ArrowArrayViewInitFromSchema(view.get(), schema, &error) != NANOARROW_OK ||
+      ArrowArrayViewSetArray(view.get(), array, &error) != NANOARROW_OK) {
+    // Not expected for arrays we just decoded, but an entry must have a size
+    return static_cast<idx_t>(array->length) * sizeof(int64_t);
+  }
+  return ArrayViewSize(view.get());
+}
+
+shared_ptr<ArrowBatchCache> ArrowBatchCache::Get(ClientContext& context) {
+  Value setting;
+  if (!context.TryGetCurrentSetting("arrow_batch_cache_size", setting) ||
+      setting.IsNull()) {
+    return nullptr;
+  }
+  idx_t capacity = DBConfig::ParseMemoryLimit(setting.ToString());
+  if (capacity == 0) {
+    return nullptr;
+  }
+  auto cache = ObjectCache::GetObjectCache(context).GetOrCreate<ArrowBatchCache>(
+      ObjectType(), capacity);
+  cache->SetCapacity(capacity);
+  return cache;
+}
+
+string ArrowBatchCache::Key(const ArrowBatchCacheFile& file, idx_t message_offset,
+                            int64_t field) {
+  return file.path + '\0' + std::to_string(file.file_size) + '\0' +
+         std::to_string(message_offset) + '\0' + std::to_string(field);
+}
+
+shared_ptr<CachedArrowArray> ArrowBatchCache::Lookup(const ArrowBatchCacheFile& file,
+                                                     idx_t message_offset,
+                                                     int64_t field) {
+  lock_guard<mutex> guard(lock);
+  auto item = index.find(Key(file, message_offset, field));
+  if (item == index.end()) {
+    return nullptr;
+  }
+  auto entry = item->second;
+  if (entry->last_modified != file.last_modified || entry->file_size != file.file_size) {
+    // The file changed since this batch was cached
+    Erase(entry);
+    return nullptr;
+  }
+  entries.splice(entries.begin(), entries, entry);
+  return entry->array;
+}
+
+void ArrowBatchCache::Insert(const ArrowBatchCacheFile& file, idx_t message_offset,
+                             int64_t field, shared_ptr<CachedArrowArray> array) {
+  lock_guard<mutex> guard(lock);
+  if (array->size_bytes > capacity) {
+    return;
+  }
+  auto key = Key(file, message_offset, field);
+  auto item = index.find(key);
+  if (item != index.end()) {
+    Erase(item->second);
+  }
+  size += array->size_bytes;
+  entries.push_front({key, file.last_modified, file.file_size, std::move(array)});
+  index[key] = entries.begin();
+  EvictToCapacity();
+}
+
+void ArrowBatchCache::SetCapacity(idx_t capacity_p) {
+  lock_guard<mutex> guard(lock);
+  capacity = capacity_p;
+  EvictToCapacity();
+}
+
+void ArrowBatchCache::Erase(list<Entry>::iterator entry) {
+  size -= entry->array->size_bytes;
+  index.erase(entry->key);
+  entries.erase(entry);
+}
+
+void ArrowBatchCache::EvictToCapacity() {
+  // Arrays still referenced by running scans are freed once those scans release them
+  while (size > capacity && !entries.empty()) {
+    Erase(std::prev(entries.end()));
+  }
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
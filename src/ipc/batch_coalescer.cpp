@@ -0,0 +1,170 @@
+#include "ipc/batch_coalescer.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include "nanoarrow_errors.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+template <class T>
+void AppendBinary(ArrowBuffer* offsets_buffer, ArrowBuffer* data_buffer,
+                  const ArrowArray& column, int64_t offset, int64_t count) {
+  auto offsets = static_cast<const T*>(column.buffers[1]) + offset;
+  auto data = static_cast<const uint8_t*>(column.buffers[2]);
+  // Offsets continue from the data that is already there
+  auto shift = data_buffer->size_bytes - static_cast<int64_t>(offsets[0]);
+  NANOARROW_THROW_NOT_OK(
+      ArrowBufferReserve(offsets_buffer, count * static_cast<int64_t>(sizeof(T))));
+  for (int64_t i = 1; i <= count; i++) {
+    auto value = static_cast<T>(static_cast<int64_t>(offsets[i]) + shift);
+    ArrowBufferAppendUnsafe(offsets_buffer, &value, sizeof(T));
+  }
+  auto data_size = static_cast<int64_t>(offsets[count] - offsets[0]);
+  if (data_size > 0) {
+    NANOARROW_THROW_NOT_OK(ArrowBufferAppend(data_buffer, data + offsets[0], data_size));
+  }
+}
+
+}  // namespace
+
+bool ArrowFlatLayout::Get(const ArrowSchema& field, ArrowFlatLayout& out) {
+  ArrowSchemaView view;
+  ArrowError error;
+  if (field.n_children != 0 || field.dictionary ||
+      ArrowSchemaViewInit(&view, &field, &error) != NANOARROW_OK ||
+      view.layout.buffer_type[0] != NANOARROW_BUFFER_TYPE_VALIDITY) {
+    return false;
+  }
+  out.value_bits = view.layout.element_size_bits[1];
+  if (view.layout.buffer_type[1] == NANOARROW_BUFFER_TYPE_DATA &&
+      view.layout.buffer_type[2] == NANOARROW_BUFFER_TYPE_NONE &&
+      (out.value_bits == 1 || (out.value_bits > 0 && out.value_bits % 8 == 0))) {
+    out.variable_size = false;
+    return true;
+  }
+  if (view.layout.buffer_type[1] == NANOARROW_BUFFER_TYPE_DATA_OFFSET &&
+      view.layout.buffer_type[2] == NANOARROW_BUFFER_TYPE_DATA &&
+      (out.value_bits == 32 || out.value_bits == 64)) {
+    out.variable_size = true;
+    return true;
+  }
+  return false;
+}
+
+bool ArrowBatchCoalescer::SupportsSchema(const ArrowSchema& schema) {
+  ArrowFlatLayout layout;
+  for (int64_t i = 0; i < schema.n_children; i++) {
+    if (!ArrowFlatLayout::Get(*schema.children[i], layout)) {
+      return false;
+    }
+  }
+  return schema.n_children > 0;
+}
+
+ArrowBatchCoalescer::ArrowBatchCoalescer(const ArrowSchema& schema) {
+  ArrowError error;
+  THROW_NOT_OK(InternalException, &error,
+               ArrowArrayInitFromSchema(array.get(), &schema, &error));
+  for (int64_t i = 0; i < schema.n_children; i++) {
+    ArrowFlatLayout layout;
+    if (!ArrowFlatLayout::Get(*schema.children[i], layout)) {
+      throw InternalException("ArrowBatchCoalescer only supports flat columns");
+    }
+    if (layout.variable_size) {
+      // The first offset
+      NANOARROW_THROW_NOT_OK(ArrowBufferAppendFill(ArrowArrayBuffer(array->children[i], 1),
+                                                   0, layout.value_bits / 8));
+    }
+    layouts.push_back(layout);
+  }
+  null_counts.resize(layouts.size());
+}
+
+bool ArrowBatchCoalescer::Append(const ArrowArray& batch) {
+  D_ASSERT(batch.n_children == array->n_children);
+  if (batch.length == 0) {
+    return true;
+  }
+  for (idx_t i = 0; i < layouts.size(); i++) {
+    if (!layouts[i].variable_size || layouts[i].value_bits != 32) {
+      continue;
+    }
+    auto& column = *batch.children[i];
+    auto offsets =
+        static_cast<const int32_t*>(column.buffers[1]) + batch.offset + column.offset;
+    auto data_size = static_cast<int64_t>(offsets[batch.length]) - offsets[0];
+    if (ArrowArrayBuffer(array->children[i], 2)->size_bytes + data_size >
+        std::numeric_limits<int32_t>::max()) {
+      return false;
+    }
+  }
+
+  // The length of the batch (not of its columns) counts, e.g., for batches sliced
+  // by a LIMIT
+  for (idx_t i = 0; i < layouts.size(); i++) {
+    auto& column = *batch.children[i];
+    AppendColumn(i, column, batch.offset + column.offset, batch.length);
+  }
+  length += batch.length;
+  return true;
+}
+
+void ArrowBatchCoalescer::AppendColumn(idx_t column_idx, const ArrowArray& column,
+                                       int64_t offset, int64_t count) {
+  auto target = array->children[column_idx];
+  auto& layout = layouts[column_idx];
+
+  auto bitmap = ArrowArrayValidityBitmap(target);
+  NANOARROW_THROW_NOT_OK(ArrowBitmapReserve(bitmap, count));
+  auto validity = static_cast<const uint8_t*>(column.buffers[0]);
+  if (!validity || column.null_count == 0) {
+    ArrowBitmapAppendUnsafe(bitmap, 1, count);
+  } else {
+    for (int64_t i = 0; i < count; i++) {
+      auto valid = ArrowBitGet(validity, offset + i);
+      ArrowBitmapAppendUnsafe(bitmap, valid, 1);
+      null_counts[column_idx] += !valid;
+    }
+  }
+
+  auto values = ArrowArrayBuffer(target, 1);
+  if (layout.variable_size) {
+    auto data = ArrowArrayBuffer(target, 2);
+    if (layout.value_bits == 32) {
+      AppendBinary<int32_t>(values, data, column, offset, count);
+    } else {
+      AppendBinary<int64_t>(values, data, column, offset, count);
+    }
+  } else if (layout.value_bits == 1) {
+    auto source = static_cast<const uint8_t*>(column.buffers[1]);
+    auto size = (length + count + 7) / 8;
+    NANOARROW_THROW_NOT_OK(ArrowBufferAppendFill(values, 0, size - values->size_bytes));
+    for (int64_t i = 0; i < count; i++) {
+      ArrowBitSetTo(values->data, length + i, ArrowBitGet(source, offset + i));
+    }
+  } else {
+    auto width = layout.value_bits / 8;
+    auto source = static_cast<const uint8_t*>(column.buffers[1]);
+    NANOARROW_THROW_NOT_OK(ArrowBufferAppend(values, source + offset * width, count * width));
+  }
+}
+
+void ArrowBatchCoalescer::Finish(ArrowArray* out) {
+  for (idx_t i = 0; i < layouts.size(); i++) {
+    array->children[i]->length = length;
+    array->children[i]->null_count = null_counts[i];
+  }
+  array->length = length;
+  array->null_count = 0;
+  ArrowError error;
+  THROW_NOT_OK(InternalException, &error,
+               ArrowArrayFinishBuildingDefault(array.get(), &error));
+  ArrowArrayMove(array.get(), out);
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,240 @@
+#include "ipc/batch_statistics.hpp"
+
+#include <algorithm>
+
+#include "ipc/bloom_filter.hpp"
+
+#include "duckdb/common/serializer/binary_deserializer.hpp"
+#include "duckdb/common/serializer/binary_serializer.hpp"
+#include "duckdb/common/serializer/memory_stream.hpp"
+#include "duckdb/storage/statistics/numeric_stats.hpp"
+#include "duckdb/storage/statistics/string_stats.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+bool HasMinMax(const LogicalType& type) {
+  if (type.id() == LogicalTypeId::ENUM) {
+    return false;
+  }
+  auto stats_type = BaseStatistics::GetStatsType(type);
+  return stats_type == StatisticsType::NUMERIC_STATS ||
+         stats_type == StatisticsType::STRING_STATS;
+}
+
+template <class T>
+void UpdateNumericStatistics(BaseStatistics& stats, Vector& vector, idx_t count) {
+  UnifiedVectorFormat format;
+  vector.ToUnifiedFormat(count, format);
+  auto data = UnifiedVectorFormat::GetData<T>(format);
+  for (idx_t i = 0; i < count; i++) {
+    auto idx = format.sel->get_index(i);
+    if (!format.validity.RowIsValid(idx)) {
+      stats.SetHasNull();
+      continue;
+    }
+    stats.SetHasNoNull();
+    NumericStats::Update<T>(stats, data[idx]);
+  }
+}
+
+void UpdateStringStatistics(BaseStatistics& stats, Vector& vector, idx_t count) {
+  UnifiedVectorFormat format;
+  vector.ToUnifiedFormat(count, format);
+  auto data = UnifiedVectorFormat::GetData<string_t>(format);
+  for (idx_t i = 0; i < count; i++) {
+    auto idx = format.sel->get_index(i);
+    if (!format.validity.RowIsValid(idx)) {
+      stats.SetHasNull();
+      continue;
+    }
+    stats.SetHasNoNull();
+    StringStats::Update(stats, data[idx]);
+  }
+}
+
+void UpdateStatistics(BaseStatistics& stats, Vector& vector, idx_t count) {
+  switch (vector.GetType().InternalType()) {
+    case PhysicalType::BOOL:
+      return UpdateNumericStatistics<bool>(stats, vector, count);
+    case PhysicalType::INT8:
+      return UpdateNumericStatistics<int8_t>(stats, vector, count);
+    case PhysicalType::INT16:
+      return UpdateNumericStatistics<int16_t>(stats, vector, count);
+    case PhysicalType::INT32:
+      return UpdateNumericStatistics<int32_t>(stats, vector, count);
+    case PhysicalType::INT64:
+      return UpdateNumericStatistics<int64_t>(stats, vector, count);
+    case PhysicalType::INT128:
+      return UpdateNumericStatistics<hugeint_t>(stats, vector, count);
+    case PhysicalType::UINT8:
+      return UpdateNumericStatistics<uint8_t>(stats, vector, count);
+    case PhysicalType::UINT16:
+      return UpdateNumericStatistics<uint16_t>(stats, vector, count);
+    case PhysicalType::UINT32:
+      return UpdateNumericStatistics<uint32_t>(stats, vector, count);
+    case PhysicalType::UINT64:
+      return UpdateNumericStatistics<uint64_t>(stats, vector, count);
+    case PhysicalType::UINT128:
+      return UpdateNumericStatistics<uhugeint_t>(stats, vector, count);
+    case PhysicalType::FLOAT:
+      return UpdateNumericStatistics<float>(stats, vector, count);
+    case PhysicalType::DOUBLE:
+      return UpdateNumericStatistics<double>(stats, vector, count);
+    case PhysicalType::VARCHAR:
+      return UpdateStringStatistics(stats, vector, count);
+    default:
+      throw InternalException("Unsupported type for Arrow batch statistics: %s",
+                              vector.GetType().ToString());
+  }
+}
+
+}  // namespace
+
+ArrowBatchStatistics ArrowBatchStatistics::Create(const vector<LogicalType>& types) {
+  ArrowBatchStatistics result;
+  for (const auto& type : types) {
+    if (HasMinMax(type)) {
+      result.columns.push_back(BaseStatistics::CreateEmpty(type));
+    } else {
+      result.columns.push_back(BaseStatistics::CreateUnknown(type));
+    }
+  }
+  result.bloom_filters.resize(types.size());
+  return result;
+}
+
+void ArrowBatchStatistics::Update(DataChunk& chunk) {
+  D_ASSERT(chunk.ColumnCount() == columns.size());
+  for (idx_t i = 0; i < chunk.ColumnCount(); i++) {
+    if (HasMinMax(chunk.data[i].GetType())) {
+      UpdateStatistics(columns[i], chunk.data[i], chunk.size());
+    }
+  }
+  row_count += chunk.size();
+}
+
+void ArrowBatchStatistics::AddBloomFilter(idx_t column_idx, Vector& values,
+                                          idx_t count) {
+  // Sized for the row count, which bounds the number of distinct values
+  ArrowBloomFilter filter(count);
+  filter.Insert(values, count);
+  bloom_filters[column_idx] = filter.Data();
+}
+
+void ArrowBatchStatistics::Serialize(Serializer& serializer) const {
+  serializer.WriteProperty<idx_t>(100, "message_offset", message_offset);
+  serializer.WriteProperty<idx_t>(101, "row_count", row_count);
+  serializer.WriteList(102, "columns", columns.size(),
+                       [&](Serializer::List& list, idx_t i) {
+                         list.WriteObject([&](Serializer& object) {
+                           columns[i].Serialize(object);
+                         });
+                       });
+  serializer.WritePropertyWithDefault<vector<string>>(103, "bloom_filters",
+                                                      bloom_filters);
+}
+
+ArrowBatchStatistics ArrowBatchStatistics::Deserialize(
+    Deserializer& deserializer, const vector<LogicalType>& types) {
+  ArrowBatchStatistics result;
+  result.message_offset = deserializer.ReadProperty<idx_t>(100, "message_offset");
+  result.row_count = deserializer.ReadProperty<idx_t>(101, "row_count");
+  deserializer.ReadList(102, "columns", [&](Deserializer::List& list, idx_t i) {
+    if (i >= types.size()) {
+      throw SerializationException("Arrow batch statistics have too many columns");
+    }
+    // BaseStatistics take their type from the deserialization context
+    deserializer.Set<const LogicalType&>(types[i]);
+    list.ReadObject([&](Deserializer& object) {
+      result.columns.push_back(BaseStatistics::Deserialize(object));
+    });
+    deserializer.Unset<LogicalType>();
+  });
+  if (result.columns.size() != types.size()) {
+    throw SerializationException("Arrow batch statistics have too few columns");
+  }
+  deserializer.ReadPropertyWithDefault<vector<string>>(103, "bloom_filters",
+                                                       result.bloom_filters);
+  result.bloom_filters.resize(types.size());
+  return result;
+}
+
+optional_ptr<ArrowBatchStatistics> ArrowFileStatistics::FindBatch(
+    idx_t message_offset) {
+  auto batch = std::lower_bound(batches.begin(), batches.end(), message_offset,
+                                [](const ArrowBatchStatistics& batch, idx_t offset) {
+                                  return batch.message_offset < offset;
+                                });
+  if (batch == batches.end() || batch->message_offset != message_offset) {
+    return nullptr;
+  }
+  return &*batch;
+}
+
+idx_t ArrowFileStatistics::RowCount() const {
+  idx_t row_count = 0;
+  for (const auto& batch : batches) {
+    row_count += batch.row_count;
+  }
+  return row_count;
+}
+
+unique_ptr<BaseStatistics> ArrowFileStatistics::ColumnStatistics(
+    idx_t column_idx) const {
+  D_ASSERT(column_idx < types.size());
+  // Empty statistics stay exact for a file without record batches
+  auto result = BaseStatistics::CreateEmpty(types[column_idx]).ToUnique();
+  for (const auto& batch : batches) {
+    result->Merge(batch.columns[column_idx]);
+  }
+  return result;
+}
+
+void ArrowFileStatistics::Write(WriteStream& stream) const {
+  MemoryStream serialized;
+  BinarySerializer::Serialize(*this, serialized);
+  auto size = static_cast<uint64_t>(serialized.GetPosition());
+  stream.WriteData(serialized.GetData(), serialized.GetPosition());
+  stream.WriteData(const_data_ptr_cast(&size), sizeof(size));
+  stream.WriteData(const_data_ptr_cast(TRAILER_MAGIC), TRAILER_MAGIC_SIZE);
+}
+
+unique_ptr<ArrowFileStatistics> ArrowFileStatistics::Read(const_data_ptr_t data,
+                                                          idx_t size) {
+  try {
+    MemoryStream stream(const_cast<data_ptr_t>(data), size);
+    return BinaryDeserializer::Deserialize<ArrowFileStatistics>(stream);
+  } catch (std::exception&) {
+    // Statistics only speed up scans, a file whose statistics we can't read is
+    // scanned without them
+    return nullptr;
+  }
+}
+
+void ArrowFileStatistics::Serialize(Serializer& serializer) const {
+  serializer.WriteProperty(100, "types", types);
+  serializer.WriteList(101, "batches", batches.size(),
+                       [&](Serializer::List& list, idx_t i) {
+                         list.WriteObject([&](Serializer& object) {
+                           batches[i].Serialize(object);
+                         });
+                       });
+}
+
+unique_ptr<ArrowFileStatistics> ArrowFileStatistics::Deserialize(
+    Deserializer& deserializer) {
+  auto result = make_uniq<ArrowFileStatistics>();
+  result->types = deserializer.ReadProperty<vector<LogicalType>>(100, "types");
+  deserializer.ReadList(101, "batches", [&](Deserializer::List& list, idx_t i) {
+    list.ReadObject([&](Deserializer& object) {
+      result->batches.push_back(ArrowBatchStatistics::Deserialize(object, result->types));
+    });
+  });
+  return result;
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,228 @@
+#include "ipc/bloom_filter.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+// Salts of the Parquet split block bloom filter
+constexpr uint32_t SALT[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                              0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+//! Upper bound of the size of one filter, larger batches get more false positives
+constexpr idx_t MAX_FILTER_SIZE = 1024 * 1024;
+
+uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+uint64_t HashBytes(const_data_ptr_t data, idx_t size) {
+  uint64_t hash = 0x9e3779b97f4a7c15ULL ^ static_cast<uint64_t>(size);
+  while (size >= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(uint64_t));
+    hash = Mix(hash ^ word);
+    data += sizeof(uint64_t);
+    size -= sizeof(uint64_t);
+  }
+  uint64_t word = 0;
+  std::memcpy(&word, data, size);
+  return Mix(hash ^ word);
+}
+
+template <class T>
+uint64_t HashValue(T value) {
+  return HashBytes(const_data_ptr_cast(&value), sizeof(T));
+}
+
+// Values that DuckDB considers equal must hash the same
+template <>
+uint64_t HashValue(float value) {
+  if (value == 0) {
+    value = 0;
+  } else if (std::isnan(value)) {
+    value = std::numeric_limits<float>::quiet_NaN();
+  }
+  return HashBytes(const_data_ptr_cast(&value), sizeof(float));
+}
+
+template <>
+uint64_t HashValue(double value) {
+  if (value == 0) {
+    value = 0;
+  } else if (std::isnan(value)) {
+    value = std::numeric_limits<double>::quiet_NaN();
+  }
+  return HashBytes(const_data_ptr_cast(&value), sizeof(double));
+}
+
+template <>
+uint64_t HashValue(string_t value) {
+  return HashBytes(const_data_ptr_cast(value.GetData()), value.GetSize());
+}
+
+template <class T, class OP>
+void HashValues(Vector& vector, idx_t count, OP&& insert) {
+  UnifiedVectorFormat format;
+  vector.ToUnifiedFormat(count, format);
+  auto data = UnifiedVectorFormat::GetData<T>(format);
+  for (idx_t i = 0; i < count; i++) {
+    auto idx = format.sel->get_index(i);
+    if (format.validity.RowIsValid(idx)) {
+      insert(HashValue<T>(data[idx]));
+    }
+  }
+}
+
+template <class OP>
+void HashVector(Vector& vector, idx_t count, OP&& insert) {
+  switch (vector.GetType().InternalType()) {
+    case PhysicalType::BOOL:
+      return HashValues<bool>(vector, count, insert);
+    case PhysicalType::INT8:
+      return HashValues<int8_t>(vector, count, insert);
+    case PhysicalType::INT16:
+      return HashValues<int16_t>(vector, count, insert);
+    case PhysicalType::INT32:
+      return HashValues<int32_t>(vector, count, insert);
+    case PhysicalType::INT64:
+      return HashValues<int64_t>(vector, count, insert);
+    case PhysicalType::INT128:
+      return HashValues<hugeint_t>(vector, count, insert);
+    case PhysicalType::UINT8:
+      return HashValues<uint8_t>(vector, count, insert);
+    case PhysicalType::UINT16:
+      return HashValues<uint16_t>(vector, count, insert);
+    case PhysicalType::UINT32:
+      return HashValues<uint32_t>(vector, count, insert);
+    case PhysicalType::UINT64:
+      return HashValues<uint64_t>(vector, count, insert);
+    case PhysicalType::UINT128:
+      return HashValues<uhugeint_t>(vector, count, insert);
+    case PhysicalType::FLOAT:
+      return HashValues<float>(vector, count, insert);
+    case PhysicalType::DOUBLE:
+      return HashValues<double>(vector, count, insert);
+    case PhysicalType::VARCHAR:
+      return HashValues<string_t>(vector, count, insert);
+    default:
+      throw InternalException("Unsupported type for an Arrow bloom filter: %s",
+                              vector.GetType().ToString());
+  }
+}
+
+uint64_t HashConstant(const Value& value) {
+  switch (value.type().InternalType()) {
+    case PhysicalType::BOOL:
+      return HashValue<bool>(value.GetValueUnsafe<bool>());
+    case PhysicalType::INT8:
+      return HashValue<int8_t>(value.GetValueUnsafe<int8_t>());
+    case PhysicalType::INT16:
+      return HashValue<int16_t>(value.GetValueUnsafe<int16_t>());
+    case PhysicalType::INT32:
+      return HashValue<int32_t>(value.GetValueUnsafe<int32_t>());
+    case PhysicalType::INT64:
+      return HashValue<int64_t>(value.GetValueUnsafe<int64_t>());
+    case PhysicalType::INT128:
+      return HashValue<hugeint_t>(value.GetValueUnsafe<hugeint_t>());
+    case PhysicalType::UINT8:
+      return HashValue<uint8_t>(value.GetValueUnsafe<uint8_t>());
+    case PhysicalType::UINT16:
+      return HashValue<uint16_t>(value.GetValueUnsafe<uint16_t>());
+    case PhysicalType::UINT32:
+      return HashValue<uint32_t>(value.GetValueUnsafe<uint32_t>());
+    case PhysicalType::UINT64:
+      return HashValue<uint64_t>(value.GetValueUnsafe<uint64_t>());
+    case PhysicalType::UINT128:
+      return HashValue<uhugeint_t>(value.GetValueUnsafe<uhugeint_t>());
+    case PhysicalType::FLOAT:
+      return HashValue<float>(value.GetValueUnsafe<float>());
+    case PhysicalType::DOUBLE:
+      return HashValue<double>(value.GetValueUnsafe<double>());
+    case PhysicalType::VARCHAR: {
+      auto& str = StringValue::Get(value);
+      return HashBytes(const_data_ptr_cast(str.data()), str.size());
+    }
+    default:
+      throw InternalException("Unsupported type for an Arrow bloom filter: %s",
+                              value.type().ToString());
+  }
+}
+
+}  // namespace
+
+ArrowBloomFilter::ArrowBloomFilter(idx_t distinct_count) {
+  // Bits per value for the false positive rate of a split block bloom filter
+  auto bits_per_value = -8.0 / std::log(1.0 - std::pow(FALSE_POSITIVE_RATE, 1.0 / 8.0));
+  auto size = static_cast<idx_t>(
+      std::ceil(static_cast<double>(distinct_count) * bits_per_value / 8.0));
+  size = MinValue<idx_t>(MaxValue<idx_t>(size, BLOCK_SIZE), MAX_FILTER_SIZE);
+  size = (size + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+  data = string(size, '\0');
+}
+
+ArrowBloomFilter::ArrowBloomFilter(string data_p) : data(std::move(data_p)) {}
+
+bool ArrowBloomFilter::SupportsType(const LogicalType& type) {
+  switch (type.InternalType()) {
+    case PhysicalType::BOOL:
+    case PhysicalType::INT8:
+    case PhysicalType::INT16:
+    case PhysicalType::INT32:
+    case PhysicalType::INT64:
+    case PhysicalType::INT128:
+    case PhysicalType::UINT8:
+    case PhysicalType::UINT16:
+    case PhysicalType::UINT32:
+    case PhysicalType::UINT64:
+    case PhysicalType::UINT128:
+    case PhysicalType::FLOAT:
+    case PhysicalType::DOUBLE:
+    case PhysicalType::VARCHAR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void ArrowBloomFilter::Insert(Vector& vector, idx_t count) {
+  HashVector(vector, count, [&](uint64_t hash) { Insert(hash); });
+}
+
+bool ArrowBloomFilter::MayContain(const string& data, const Value& value) {
+  idx_t block_count = data.size() / BLOCK_SIZE;
+  if (block_count == 0 || value.IsNull() || !SupportsType(value.type())) {
+    return true;
+  }
+  auto hash = HashConstant(value);
+  auto block_idx = ((hash >> 32) * block_count) >> 32;
+  auto block = reinterpret_cast<const uint32_t*>(&data[block_idx * BLOCK_SIZE]);
+  auto key = static_cast<uint32_t>(hash);
+  for (idx_t i = 0; i < 8; i++) {
+    if (!(block[i] & (1U << ((key * SALT[i]) >> 27)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ArrowBloomFilter::Insert(uint64_t hash) {
+  auto block_idx = ((hash >> 32) * (data.size() / BLOCK_SIZE)) >> 32;
+  auto block = reinterpret_cast<uint32_t*>(&data[block_idx * BLOCK_SIZE]);
+  auto key = static_cast<uint32_t>(hash);
+  for (idx_t i = 0; i < 8; i++) {
+    block[i] |= 1U << ((key * SALT[i]) >> 27);
+  }
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
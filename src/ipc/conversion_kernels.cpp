@@ -0,0 +1,199 @@
+#include "ipc/conversion_kernels.hpp"
+
+#include <cstring>
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+//! The kernels are plain loops over the values (with the factor known at compile
+//! time and no branches), which the compiler turns into SIMD code
+
+template <class SRC, class DST, int64_t FACTOR>
+bool MultiplyKernel(const_data_ptr_t source, data_ptr_t target, idx_t count) {
+  auto src = reinterpret_cast<const SRC*>(source);
+  auto dst = reinterpret_cast<DST*>(target);
+  for (idx_t i = 0; i < count; i++) {
+    dst[i] = static_cast<DST>(static_cast<int64_t>(src[i]) * FACTOR);
+  }
+  return false;
+}
+
+//! Products that overflow wrap around, which is only an error for valid values
+template <int64_t FACTOR>
+bool CheckedMultiplyKernel(const_data_ptr_t source, data_ptr_t target, idx_t count) {
+  constexpr int64_t MAX = NumericLimits<int64_t>::Maximum() / FACTOR;
+  constexpr int64_t MIN = NumericLimits<int64_t>::Minimum() / FACTOR;
+  auto src = reinterpret_cast<const int64_t*>(source);
+  auto dst = reinterpret_cast<int64_t*>(target);
+  bool overflow = false;
+  for (idx_t i = 0; i < count; i++) {
+    auto value = src[i];
+    overflow |= (value > MAX) | (value < MIN);
+    dst[i] = static_cast<int64_t>(static_cast<uint64_t>(value) *
+                                  static_cast<uint64_t>(FACTOR));
+  }
+  return overflow;
+}
+
+//! Truncates, like the Arrow scan does
+template <class DST, int64_t DIVISOR>
+bool DivideKernel(const_data_ptr_t source, data_ptr_t target, idx_t count) {
+  auto src = reinterpret_cast<const int64_t*>(source);
+  auto dst = reinterpret_cast<DST*>(target);
+  for (idx_t i = 0; i < count; i++) {
+    dst[i] = static_cast<DST>(src[i] / DIVISOR);
+  }
+  return false;
+}
+
+//! A record batch whose top-level columns were (partly) converted. It keeps the
+//! original record batch alive, which owns the buffers that weren't converted.
+//! Record batches of the batch cache are shared, so they are never modified.
+struct ConvertedBatch {
+  ArrowArray original;
+  vector<ArrowArray> children;
+  vector<ArrowArray*> child_pointers;
+  //! Validity and values buffer of each column
+  vector<const void*> buffers;
+  vector<AllocatedData> values;
+};
+
+//! The columns are owned by their record batch
+void ReleaseConvertedColumn(ArrowArray* array) { array->release = nullptr; }
+
+void ReleaseConvertedBatch(ArrowArray* array) {
+  auto converted = static_cast<ConvertedBatch*>(array->private_data);
+  for (auto& child : converted->children) {
+    if (child.release) {
+      child.release(&child);
+    }
+  }
+  if (converted->original.release) {
+    converted->original.release(&converted->original);
+  }
+  delete converted;
+  array->release = nullptr;
+}
+
+}  // namespace
+
+unique_ptr<ArrowConversionKernel> ArrowConversionKernel::Create(
+    const ArrowSchema& field) {
+  if (field.dictionary || !field.format || field.format[0] != 't' ||
+      field.format[1] == '\0' || field.format[2] == '\0') {
+    return nullptr;
+  }
+  string format(field.format);
+  unique_ptr<ArrowConversionKernel> result;
+  if (format == "tts") {
+    result.reset(new ArrowConversionKernel(
+        "ttu", MultiplyKernel<int32_t, int64_t, 1000000>, sizeof(int32_t),
+        sizeof(int64_t)));
+  } else if (format == "ttm") {
+    result.reset(new ArrowConversionKernel("ttu", MultiplyKernel<int32_t, int64_t, 1000>,
+                                           sizeof(int32_t), sizeof(int64_t)));
+  } else if (format == "tdm") {
+    result.reset(new ArrowConversionKernel("tdD", DivideKernel<int32_t, 86400000>,
+                                           sizeof(int64_t), sizeof(int32_t)));
+  } else if (format.size() > 4 && format[3] == ':') {
+    // Timestamps with a timezone are TIMESTAMP WITH TIME ZONE, which is always in
+    // microseconds. Timestamps without one keep their unit and are zero-copy.
+    auto unit = format.substr(0, 3);
+    if (unit == "tss") {
+      result.reset(new ArrowConversionKernel("tsu", CheckedMultiplyKernel<1000000>,
+                                             sizeof(int64_t), sizeof(int64_t), 1000000));
+    } else if (unit == "tsm") {
+      result.reset(new ArrowConversionKernel("tsu", CheckedMultiplyKernel<1000>,
+                                             sizeof(int64_t), sizeof(int64_t), 1000));
+    } else if (unit == "tsn") {
+      result.reset(new ArrowConversionKernel("tsu", DivideKernel<int64_t, 1000>,
+                                             sizeof(int64_t), sizeof(int64_t)));
+    }
+  }
+  return result;
+}
+
+bool ArrowConversionKernel::ConvertSchema(ArrowSchema& schema) {
+  bool converted = false;
+  for (int64_t i = 0; i < schema.n_children; i++) {
+    auto& field = *schema.children[i];
+    auto kernel = Create(field);
+    if (!kernel) {
+      continue;
+    }
+    // Keeps the timezone of timestamps
+    auto format = string(kernel->target_format) + string(field.format + 3);
+    NANOARROW_THROW_NOT_OK(ArrowSchemaSetFormat(&field, format.c_str()));
+    converted = true;
+  }
+  return converted;
+}
+
+void ArrowConversionKernel::ConvertBatch(
+    const vector<unique_ptr<ArrowConversionKernel>>& kernels, ArrowArray& batch,
+    Allocator& allocator) {
+  auto column_count = static_cast<idx_t>(batch.n_children);
+  auto converted = make_uniq<ConvertedBatch>();
+  converted->children.resize(column_count);
+  converted->child_pointers.resize(column_count);
+  converted->buffers.resize(column_count * 2);
+  for (idx_t i = 0; i < column_count; i++) {
+    const ArrowArray& column = *batch.children[i];
+    auto& out = converted->children[i];
+    out = column;
+    out.private_data = nullptr;
+    out.release = ReleaseConvertedColumn;
+    converted->child_pointers[i] = &out;
+    if (i >= kernels.size() || !kernels[i] || column.n_buffers != 2 ||
+        !column.buffers[1] || column.length == 0) {
+      continue;
+    }
+    converted->values.push_back(kernels[i]->Convert(column, allocator));
+    converted->buffers[i * 2] = column.buffers[0];
+    converted->buffers[i * 2 + 1] = converted->values.back().get();
+    out.buffers = &converted->buffers[i * 2];
+  }
+
+  std::memcpy(&converted->original, &batch, sizeof(ArrowArray));
+  batch.children = converted->child_pointers.data();
+  batch.release = ReleaseConvertedBatch;
+  batch.private_data = converted.release();
+}
+
+AllocatedData ArrowConversionKernel::Convert(const ArrowArray& column,
+                                             Allocator& allocator) const {
+  // The values before the offset are left alone, so that the validity buffer can be
+  // shared with the original column
+  auto offset = static_cast<idx_t>(column.offset);
+  auto values = allocator.Allocate((offset + static_cast<idx_t>(column.length)) *
+                                   target_width);
+  auto source = static_cast<const_data_ptr_t>(column.buffers[1]) + offset * source_width;
+  if (kernel(source, values.get() + offset * target_width,
+             static_cast<idx_t>(column.length))) {
+    CheckOverflow(column);
+  }
+  return values;
+}
+
+void ArrowConversionKernel::CheckOverflow(const ArrowArray& column) const {
+  auto values = static_cast<const int64_t*>(column.buffers[1]);
+  auto validity = static_cast<const uint8_t*>(column.buffers[0]);
+  auto max = NumericLimits<int64_t>::Maximum() / overflow_factor;
+  auto min = NumericLimits<int64_t>::Minimum() / overflow_factor;
+  for (int64_t row = column.offset; row < column.offset + column.length; row++) {
+    if (validity && column.null_count != 0 && !ArrowBitGet(validity, row)) {
+      continue;
+    }
+    if (values[row] > max || values[row] < min) {
+      throw ConversionException("Could not convert TimestampTZ to Microsecond");
+    }
+  }
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,184 @@
+#include "ipc/ipc_metadata.hpp"
+
+#include "duckdb/common/radix.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+// Field ids and enum values from Message.fbs and File.fbs in the Arrow format
+constexpr int kMessageHeaderTypeField = 1;
+constexpr int kMessageHeaderField = 2;
+constexpr uint8_t kMessageHeaderRecordBatch = 3;
+constexpr int kRecordBatchLengthField = 0;
+constexpr int kRecordBatchNodesField = 1;
+constexpr int kRecordBatchBuffersField = 2;
+constexpr int kRecordBatchCompressionField = 3;
+constexpr int kFooterRecordBatchesField = 3;
+constexpr int64_t kFieldNodeSize = 16;
+constexpr int64_t kBufferSize = 16;
+constexpr int64_t kBlockSize = 24;
+
+//! Bounds checked access to a little-endian flatbuffer
+class FlatbufferReader {
+ public:
+  explicit FlatbufferReader(ArrowBufferView view)
+      : data(view.data.as_uint8), size(view.size_bytes) {}
+
+  template <typename T>
+  bool Read(int64_t pos, T& out) const {
+    if (pos < 0 || pos + static_cast<int64_t>(sizeof(T)) > size) {
+      return false;
+    }
+    std::memcpy(&out, data + pos, sizeof(T));
+    return true;
+  }
+
+  //! Follows the uoffset stored at pos
+  bool Offset(int64_t pos, int64_t& target) const {
+    uint32_t offset;
+    if (!Read(pos, offset)) {
+      return false;
+    }
+    target = pos + offset;
+    return target < size;
+  }
+
+  bool Root(int64_t& table) const { return Offset(0, table); }
+
+  //! Finds the position of a field of a table, returns false if it is absent
+  bool Field(int64_t table, int field_id, int64_t& pos) const {
+    int32_t vtable_offset;
+    if (!Read(table, vtable_offset)) {
+      return false;
+    }
+    int64_t vtable = table - vtable_offset;
+    uint16_t vtable_size;
+    if (!Read(vtable, vtable_size)) {
+      return false;
+    }
+    int64_t entry = 4 + 2 * static_cast<int64_t>(field_id);
+    if (entry + 2 > vtable_size) {
+      return false;
+    }
+    uint16_t field_offset;
+    if (!Read(vtable + entry, field_offset) || field_offset == 0) {
+      return false;
+    }
+    pos = table + field_offset;
+    return true;
+  }
+
+  //! Finds the elements of a vector field of a table
+  bool Vector(int64_t table, int field_id, int64_t element_size, int64_t& start,
+              int64_t& count) const {
+    int64_t pos;
+    int64_t vector;
+    uint32_t length;
+    if (!Field(table, field_id, pos)) {
+      // An absent vector is an empty vector
+      start = 0;
+      count = 0;
+      return true;
+    }
+    if (!Offset(pos, vector) || !Read(vector, length)) {
+      return false;
+    }
+    start = vector + 4;
+    count = length;
+    return start + count * element_size <= size;
+  }
+
+ private:
+  const uint8_t* data;
+  int64_t size;
+};
+
+}  // namespace
+
+bool IPCMetadata::DecodeRecordBatchHeader(ArrowBufferView message,
+                                          IPCRecordBatchHeader& out) {
+  if (!Radix::IsLittleEndian()) {
+    return false;
+  }
+
+  FlatbufferReader reader(message);
+  int64_t message_table;
+  int64_t pos;
+  uint8_t header_type;
+  if (!reader.Root(message_table) ||
+      !reader.Field(message_table, kMessageHeaderTypeField, pos) ||
+      !reader.Read(pos, header_type) || header_type != kMessageHeaderRecordBatch) {
+    return false;
+  }
+
+  int64_t batch_table;
+  if (!reader.Field(message_table, kMessageHeaderField, pos) ||
+      !reader.Offset(pos, batch_table)) {
+    return false;
+  }
+
+  out.length = 0;
+  if (reader.Field(batch_table, kRecordBatchLengthField, pos) &&
+      !reader.Read(pos, out.length)) {
+    return false;
+  }
+
+  int64_t start;
+  int64_t count;
+  if (!reader.Vector(batch_table, kRecordBatchNodesField, kFieldNodeSize, start,
+                     count)) {
+    return false;
+  }
+  out.nodes.resize(static_cast<idx_t>(count));
+  for (int64_t i = 0; i < count; i++) {
+    auto& node = out.nodes[static_cast<idx_t>(i)];
+    reader.Read(start + i * kFieldNodeSize, node.length);
+    reader.Read(start + i * kFieldNodeSize + 8, node.null_count);
+  }
+
+  if (!reader.Vector(batch_table, kRecordBatchBuffersField, kBufferSize, start,
+                     count)) {
+    return false;
+  }
+  out.buffers.resize(static_cast<idx_t>(count));
+  for (int64_t i = 0; i < count; i++) {
+    auto& buffer = out.buffers[static_cast<idx_t>(i)];
+    reader.Read(start + i * kBufferSize, buffer.offset);
+    reader.Read(start + i * kBufferSize + 8, buffer.length);
+  }
+
+  out.compressed = reader.Field(batch_table, kRecordBatchCompressionField, pos);
+  return true;
+}
+
+bool IPCMetadata::DecodeFooterBlocks(ArrowBufferView footer, vector<IPCFileBlock>& out) {
+  if (!Radix::IsLittleEndian()) {
+    return false;
+  }
+
+  FlatbufferReader reader(footer);
+  int64_t footer_table;
+  int64_t start;
+  int64_t count;
+  if (!reader.Root(footer_table) ||
+      !reader.Vector(footer_table, kFooterRecordBatchesField, kBlockSize, start,
+                     count)) {
+    return false;
+  }
+
+  // Block is a struct of { offset: long; metaDataLength: int; bodyLength: long }
+  // with four bytes of padding after metaDataLength
+  out.resize(static_cast<idx_t>(count));
+  for (int64_t i = 0; i < count; i++) {
+    auto& block = out[static_cast<idx_t>(i)];
+    reader.Read(start + i * kBlockSize, block.offset);
+    reader.Read(start + i * kBlockSize + 8, block.metadata_length);
+    reader.Read(start + i * kBlockSize + 16, block.body_length);
+  }
+  return true;
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,275 @@
+#include "ipc/read_ahead_file_reader.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/limits.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+ReadAheadFileReader::ReadAheadFileReader(unique_ptr<FileHandle> handle_p,
+                                         Allocator& allocator, bool direct_io,
+                                         idx_t read_ahead_size)
+    : handle(std::move(handle_p)),
+      allocator(allocator),
+      seekable(handle->CanSeek() && !handle->IsPipe()),
+      direct_io(direct_io && seekable),
+      read_ahead_size(read_ahead_size),
+      file_size(seekable ? static_cast<idx_t>(handle->GetFileSize()) : 0),
+      read_end(seekable ? file_size : NumericLimits<idx_t>::Maximum()) {}
+
+bool ReadAheadFileReader::InWindow(idx_t size) const {
+  return window && offset >= window_start &&
+         offset + size <= window_start + window_size;
+}
+
+bool ReadAheadFileReader::InTail(idx_t size) const {
+  return tail && offset >= tail_start && offset + size <= file_size;
+}
+
+bool ReadAheadFileReader::Exhausted(idx_t size) {
+  if (seekable) {
+    return offset + size > read_end;
+  }
+  if (!InWindow(size)) {
+    FillSequentialWindow(size);
+  }
+  return !InWindow(size);
+}
+
+void ReadAheadFileReader::CheckAvailable(idx_t size) {
+  if (Exhausted(size)) {
+    throw IOException("Attempted to read %llu bytes at offset %llu from '%s' but the "
+                      "readable part of the file ends at %llu",
+                      size, offset, handle->GetPath(), read_end);
+  }
+}
+
+void ReadAheadFileReader::ReadRange(data_ptr_t ptr, idx_t start, idx_t end) {
+  if (!direct_io) {
+    handle->Read(ptr, end - start, start);
+    return;
+  }
+
+  // O_DIRECT requires the length to be a multiple of the block size too. Past the
+  // end of the file the kernel returns a short read, which is why we can't use the
+  // positioned Read() (it treats short reads as errors).
+  idx_t aligned_end = AlignValue<idx_t, DIRECT_IO_ALIGNMENT>(end);
+  handle->Seek(start);
+  idx_t total_read = 0;
+  while (start + total_read < end) {
+    auto bytes_read = handle->Read(ptr + total_read, aligned_end - start - total_read);
+    if (bytes_read <= 0) {
+      throw IOException("Could not read %llu bytes at offset %llu from '%s'",
+                        end - start, start, handle->GetPath());
+    }
+    total_read += static_cast<idx_t>(bytes_read);
+  }
+}
+
+void ReadAheadFileReader::FillSequentialWindow(idx_t size) {
+  // Everything before the end of the window was read from the source already
+  idx_t source_offset = window ? window_start + window_size : 0;
+  // The window is kept from the 8-byte boundary before offset on, so that slices of
+  // the new window are as aligned as their offsets
+  idx_t start = offset - (offset % 8);
+  if (start < window_start || start > source_offset) {
+    start = offset;
+  }
+  auto capacity = MaxValue<idx_t>(offset - start + size, read_ahead_size);
+  auto new_window = make_shared_ptr<AllocatedData>(allocator.Allocate(capacity));
+  idx_t new_size = 0;
+  if (start < source_offset) {
+    new_size = source_offset - start;
+    std::memcpy(new_window->get(), window_ptr + (start - window_start), new_size);
+  }
+  // Bytes that were skipped are read and dropped
+  while (source_offset < start) {
+    auto bytes_read = handle->Read(new_window->get(),
+                                   MinValue<idx_t>(capacity, start - source_offset));
+    if (bytes_read <= 0) {
+      break;
+    }
+    source_offset += static_cast<idx_t>(bytes_read);
+  }
+  // A read returns what the source has at the moment, which may be less
+  while (source_offset == start + new_size && new_size < offset - start + size) {
+    auto bytes_read = handle->Read(new_window->get() + new_size, capacity - new_size);
+    if (bytes_read <= 0) {
+      break;
+    }
+    new_size += static_cast<idx_t>(bytes_read);
+    source_offset += static_cast<idx_t>(bytes_read);
+  }
+  window = std::move(new_window);
+  window_ptr = window->get();
+  window_start = start;
+  window_size = new_size;
+}
+
+data_ptr_t ReadAheadFileReader::ReadBlock(idx_t start, idx_t end,
+                                          shared_ptr<AllocatedData>& data) {
+  // A new allocation: slices handed out earlier may still reference the old one
+  data_ptr_t ptr;
+  if (direct_io) {
+    idx_t aligned_size = AlignValue<idx_t, DIRECT_IO_ALIGNMENT>(end - start);
+    data = make_shared_ptr<AllocatedData>(
+        allocator.Allocate(aligned_size + DIRECT_IO_ALIGNMENT));
+    auto address = reinterpret_cast<uintptr_t>(data->get());
+    ptr = reinterpret_cast<data_ptr_t>(
+        AlignValue<uintptr_t, DIRECT_IO_ALIGNMENT>(address));
+  } else {
+    data = make_shared_ptr<AllocatedData>(allocator.Allocate(end - start));
+    ptr = data->get();
+  }
+  ReadRange(ptr, start, end);
+  return ptr;
+}
+
+void ReadAheadFileReader::FillWindow(idx_t size) {
+  if (!seekable) {
+    FillSequentialWindow(size);
+    return;
+  }
+  // IPC message bodies start at 8-byte aligned file offsets. Starting the window
+  // at an aligned offset keeps slices of it aligned in memory as well.
+  idx_t alignment = direct_io ? DIRECT_IO_ALIGNMENT : 8;
+  idx_t start = offset - (offset % alignment);
+  idx_t end = MinValue<idx_t>(read_end, MaxValue<idx_t>(offset + size,
+                                                         start + read_ahead_size));
+  window_ptr = ReadBlock(start, end, window);
+  window_start = start;
+  window_size = end - start;
+}
+
+void ReadAheadFileReader::ReadData(data_ptr_t ptr, idx_t size) {
+  CheckAvailable(size);
+  if (!InWindow(size)) {
+    if (InTail(size)) {
+      // E.g., the footer of the file
+      std::memcpy(ptr, tail_ptr + (offset - tail_start), size);
+      offset += size;
+      return;
+    }
+    if (size >= read_ahead_size && !direct_io && seekable) {
+      // Large reads go straight to the caller's memory
+      ReadRange(ptr, offset, offset + size);
+      offset += size;
+      return;
+    }
+    FillWindow(size);
+  }
+  std::memcpy(ptr, window_ptr + (offset - window_start), size);
+  offset += size;
+}
+
+ReadBufferSlice ReadAheadFileReader::ReadBuffer(idx_t size) {
+  CheckAvailable(size);
+  ReadBufferSlice slice;
+  if (!InWindow(size)) {
+    if (InTail(size)) {
+      // The tail is small, copying doesn't keep it alive
+      slice.owner = make_shared_ptr<AllocatedData>(allocator.Allocate(size));
+      slice.ptr = slice.owner->get();
+      slice.size = size;
+      std::memcpy(slice.ptr, tail_ptr + (offset - tail_start), size);
+      offset += size;
+      return slice;
+    }
+    if (size >= read_ahead_size && !direct_io && seekable) {
+      // Buffers larger than the window get their own allocation
+      slice.owner = make_shared_ptr<AllocatedData>(allocator.Allocate(size));
+      slice.ptr = slice.owner->get();
+      slice.size = size;
+      ReadRange(slice.ptr, offset, offset + size);
+      offset += size;
+      return slice;
+    }
+    FillWindow(size);
+  }
+  auto ptr = window_ptr + (offset - window_start);
+  if (size < read_ahead_size / MIN_SLICE_FRACTION ||
+      reinterpret_cast<uintptr_t>(ptr) % 8 != 0) {
+    // Cheaper to copy than to keep the window alive for as long as the batch is
+    slice.owner = make_shared_ptr<AllocatedData>(allocator.Allocate(size));
+    slice.ptr = slice.owner->get();
+    std::memcpy(slice.ptr, ptr, size);
+  } else {
+    slice.owner = window;
+    slice.ptr = ptr;
+  }
+  slice.size = size;
+  offset += size;
+  return slice;
+}
+
+void ReadAheadFileReader::Skip(idx_t size) {
+  if (!seekable && !InWindow(size)) {
+    // The skipped bytes are dropped when the window is refilled, a source that ends
+    // before is exhausted then
+    offset += size;
+    return;
+  }
+  CheckAvailable(size);
+  offset += size;
+}
+
+void ReadAheadFileReader::Seek(idx_t offset_p) {
+  if (!seekable) {
+    if (offset_p < (window ? window_start : offset)) {
+      throw IOException("Cannot seek back to offset %llu in '%s', which is read "
+                        "sequentially",
+                        offset_p, handle->GetPath());
+    }
+    offset = offset_p;
+    return;
+  }
+  if (offset_p > file_size) {
+    throw IOException("Attempted to seek to offset %llu in '%s' but the file is only "
+                      "%llu bytes long",
+                      offset_p, handle->GetPath(), file_size);
+  }
+  offset = offset_p;
+}
+
+void ReadAheadFileReader::SetRange(idx_t start, idx_t end) {
+  if (start > end || end > file_size) {
+    throw IOException("Invalid range [%llu, %llu) of '%s', which is %llu bytes long",
+                      start, end, handle->GetPath(), file_size);
+  }
+  read_end = end;
+  offset = start;
+  if (InWindow(1)) {
+    // E.g., the first record batches of a file that was prefetched
+    return;
+  }
+  window.reset();
+  window_ptr = nullptr;
+  window_start = 0;
+  window_size = 0;
+}
+
+void ReadAheadFileReader::Prefetch() {
+  if (!Exhausted() && !InWindow(1)) {
+    FillWindow(1);
+  }
+}
+
+void ReadAheadFileReader::PrefetchTail(idx_t size) {
+  if (!seekable || read_end != file_size || file_size == 0) {
+    return;
+  }
+  idx_t start = file_size > size ? file_size - size : 0;
+  if (direct_io) {
+    start -= start % DIRECT_IO_ALIGNMENT;
+  }
+  if ((tail && tail_start <= start) ||
+      (window && window_start <= start && window_start + window_size == file_size)) {
+    // Read already, e.g., by ReadFooterBlocks() before ReadStatistics()
+    return;
+  }
+  tail_ptr = ReadBlock(start, file_size, tail);
+  tail_start = start;
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
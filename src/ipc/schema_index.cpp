@@ -0,0 +1,84 @@
+#include "ipc/schema_index.hpp"
+
+#include "duckdb/main/query_result.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+int64_t CountFields(const ArrowSchema& schema) {
+  int64_t n_fields = 1;
+  for (int64_t i = 0; i < schema.n_children; i++) {
+    n_fields += CountFields(*schema.children[i]);
+  }
+  return n_fields;
+}
+
+//! Adds the index of the first body buffer of a field and of its children, which
+//! follow each other in depth-first order. Returns false if the number of buffers
+//! depends on the record batch (i.e., the variadic buffers of view types).
+bool AddFieldBuffers(const ArrowSchema& field, int64_t& buffer_count,
+                     vector<int64_t>& field_buffers) {
+  ArrowSchemaView view;
+  ArrowError error;
+  if (ArrowSchemaViewInit(&view, &field, &error) != NANOARROW_OK ||
+      view.type == NANOARROW_TYPE_BINARY_VIEW || view.type == NANOARROW_TYPE_STRING_VIEW) {
+    return false;
+  }
+  field_buffers.push_back(buffer_count);
+  for (int i = 0; i < NANOARROW_MAX_FIXED_BUFFERS; i++) {
+    if (view.layout.buffer_type[i] != NANOARROW_BUFFER_TYPE_NONE) {
+      buffer_count++;
+    }
+  }
+  for (int64_t i = 0; i < field.n_children; i++) {
+    if (!AddFieldBuffers(*field.children[i], buffer_count, field_buffers)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+IPCSchemaIndex::IPCSchemaIndex(const ArrowSchema& schema) {
+  for (int64_t i = 0; i < schema.n_children; i++) {
+    auto name = schema.children[i]->name;
+    names.push_back(name ? name : "");
+  }
+  QueryResult::DeduplicateColumns(names);
+
+  int64_t field_count = 0;
+  for (idx_t i = 0; i < names.size(); i++) {
+    if (!columns.emplace(names[i], i).second) {
+      duplicate_names.insert(names[i]);
+    }
+    column_fields.push_back(field_count);
+    field_count += CountFields(*schema.children[i]);
+  }
+
+  for (int64_t i = 0; i < schema.n_children; i++) {
+    if (!AddFieldBuffers(*schema.children[i], buffer_count, field_buffers)) {
+      field_buffers.clear();
+      buffer_count = 0;
+      break;
+    }
+  }
+}
+
+idx_t IPCSchemaIndex::GetColumn(const string& name) const {
+  if (duplicate_names.find(name) != duplicate_names.end()) {
+    throw InternalException(string("Field '") + name +
+                            "' refers to a duplicate column name in IPC file schema");
+  }
+  auto entry = columns.find(name);
+  if (entry == columns.end()) {
+    throw InternalException(string("Field '") + name +
+                            "' does not exist in IPC file schema");
+  }
+  return entry->second;
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
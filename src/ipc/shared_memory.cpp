@@ -0,0 +1,71 @@
+#include "ipc/shared_memory.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include "duckdb/common/exception.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+#ifdef _WIN32
+unique_ptr<SharedMemoryMapping> SharedMemoryMapping::OpenName(const string& name) {
+  throw NotImplementedException(
+      "Scanning POSIX shared memory is not supported on Windows");
+}
+
+unique_ptr<SharedMemoryMapping> SharedMemoryMapping::Map(int fd,
+                                                         const string& description) {
+  throw NotImplementedException("Scanning shared memory is not supported on Windows");
+}
+
+SharedMemoryMapping::~SharedMemoryMapping() {}
+#else
+unique_ptr<SharedMemoryMapping> SharedMemoryMapping::OpenName(const string& name) {
+  // shm_open() names start with a slash, which is often left out
+  auto shm_name = !name.empty() && name[0] == '/' ? name : "/" + name;
+  int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    throw IOException("Could not open shared memory \"%s\": %s", name, strerror(errno));
+  }
+  // The mapping stays valid after the descriptor is closed
+  try {
+    auto mapping = Map(fd, "shared memory \"" + name + "\"");
+    close(fd);
+    return mapping;
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+}
+
+unique_ptr<SharedMemoryMapping> SharedMemoryMapping::Map(int fd,
+                                                         const string& description) {
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    throw IOException("Could not get the size of %s: %s", description, strerror(errno));
+  }
+  if (file_stat.st_size <= 0) {
+    throw InvalidInputException("Cannot scan %s: it is empty", description);
+  }
+  auto size = static_cast<idx_t>(file_stat.st_size);
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    throw IOException("Could not map %s: %s", description, strerror(errno));
+  }
+  return unique_ptr<SharedMemoryMapping>(
+      new SharedMemoryMapping(static_cast<data_ptr_t>(data), size));
+}
+
+SharedMemoryMapping::~SharedMemoryMapping() { munmap(data, size); }
+#endif
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
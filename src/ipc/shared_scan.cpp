@@ -0,0 +1,102 @@
+#include "ipc/shared_scan.hpp"
+
+#include "duckdb/main/config.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+ArrowSharedScan::ArrowSharedScan(ArrowBatchCacheFile file_p)
+    : window(make_shared_ptr<ArrowBatchCache>(0)), file(std::move(file_p)) {
+  window->SetActive(false);
+}
+
+void ArrowSharedScan::StartUnit(idx_t offset) {
+  lock_guard<mutex> guard(lock);
+  latest_unit = offset;
+}
+
+optional_idx ArrowSharedScan::LatestUnit() {
+  lock_guard<mutex> guard(lock);
+  return latest_unit;
+}
+
+ArrowSharedScanHandle::ArrowSharedScanHandle(shared_ptr<ArrowSharedScans> registry,
+                                             shared_ptr<ArrowSharedScan> scan)
+    : registry(std::move(registry)), scan(std::move(scan)) {}
+
+ArrowSharedScanHandle::~ArrowSharedScanHandle() { registry->Unregister(*scan); }
+
+idx_t ArrowSharedScans::WindowBudget(ClientContext& context) {
+  Value setting;
+  if (!context.TryGetCurrentSetting("arrow_shared_scan_window", setting) ||
+      setting.IsNull()) {
+    return 0;
+  }
+  return DBConfig::ParseMemoryLimit(setting.ToString());
+}
+
+unique_ptr<ArrowSharedScanHandle> ArrowSharedScans::Register(
+    ClientContext& context, const ArrowBatchCacheFile& file, idx_t window_budget) {
+  auto registry = ObjectCache::GetObjectCache(context).GetOrCreate<ArrowSharedScans>(
+      ObjectType());
+
+  lock_guard<mutex> guard(registry->lock);
+  if (registry->window_budget != window_budget) {
+    registry->window_budget = window_budget;
+    registry->ResizeWindows();
+  }
+  auto& scan = registry->scans[file.path];
+  if (!scan || scan->file.last_modified != file.last_modified ||
+      scan->file.file_size != file.file_size) {
+    // Scans of an older version of the file keep their own window until they end
+    scan = make_shared_ptr<ArrowSharedScan>(file);
+  }
+  scan->scan_count++;
+  registry->UpdateWindow(*scan);
+  return make_uniq<ArrowSharedScanHandle>(registry, scan);
+}
+
+void ArrowSharedScans::Unregister(ArrowSharedScan& scan) {
+  lock_guard<mutex> guard(lock);
+  scan.scan_count--;
+  UpdateWindow(scan);
+  auto entry = scans.find(scan.file.path);
+  if (scan.scan_count == 0 && entry != scans.end() && entry->second.get() == &scan) {
+    scans.erase(entry);
+  }
+}
+
+void ArrowSharedScans::UpdateWindow(ArrowSharedScan& scan) {
+  bool shared = scan.scan_count > 1;
+  if (shared == scan.window->IsActive()) {
+    return;
+  }
+  scan.window->SetActive(shared);
+  if (shared) {
+    active_scans.push_back(scan);
+  } else {
+    // A scan that runs alone has no use for the batches of the others
+    for (idx_t i = 0; i < active_scans.size(); i++) {
+      if (&active_scans[i].get() == &scan) {
+        active_scans.erase(active_scans.begin() + static_cast<int64_t>(i));
+        break;
+      }
+    }
+    scan.window->SetCapacity(0);
+  }
+  ResizeWindows();
+}
+
+void ArrowSharedScans::ResizeWindows() {
+  if (active_scans.empty()) {
+    return;
+  }
+  // Concurrent scans of N files hold at most the budget together, not N windows
+  idx_t window_size = window_budget / active_scans.size();
+  for (auto& scan : active_scans) {
+    scan.get().window->SetCapacity(window_size);
+  }
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -0,0 +1,66 @@
+#include "ipc/sort_order.hpp"
+
+#include "duckdb/parser/expression/columnref_expression.hpp"
+#include "duckdb/parser/keyword_helper.hpp"
+#include "duckdb/parser/parser.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+vector<ArrowSortKey> ArrowSortOrder::Parse(const string& order_list) {
+  vector<ArrowSortKey> keys;
+  for (auto& order : Parser::ParseOrderList(order_list)) {
+    if (order.expression->GetExpressionType() != ExpressionType::COLUMN_REF) {
+      throw ParserException("Sort order can only contain column names, not \"%s\"",
+                            order.expression->ToString());
+    }
+    auto& column_ref = order.expression->Cast<ColumnRefExpression>();
+    if (column_ref.IsQualified()) {
+      throw ParserException("Sort order can only contain column names, not \"%s\"",
+                            column_ref.ToString());
+    }
+
+    ArrowSortKey key;
+    key.column = column_ref.GetColumnName();
+    key.type = order.type == OrderType::DESCENDING ? OrderType::DESCENDING
+                                                   : OrderType::ASCENDING;
+    key.null_order = order.null_order == OrderByNullType::NULLS_FIRST
+                         ? OrderByNullType::NULLS_FIRST
+                         : OrderByNullType::NULLS_LAST;
+    keys.push_back(std::move(key));
+  }
+  return keys;
+}
+
+string ArrowSortOrder::ToString(const vector<ArrowSortKey>& keys) {
+  string result;
+  for (const auto& key : keys) {
+    if (!result.empty()) {
+      result += ", ";
+    }
+    result += KeywordHelper::WriteOptionallyQuoted(key.column);
+    result += key.type == OrderType::DESCENDING ? " DESC" : " ASC";
+    result += key.null_order == OrderByNullType::NULLS_FIRST ? " NULLS FIRST"
+                                                             : " NULLS LAST";
+  }
+  return result;
+}
+
+vector<ArrowSortKey> ArrowSortOrder::FromSchema(const ArrowSchema& schema) {
+  ArrowStringView value{nullptr, 0};
+  if (ArrowMetadataGetValue(schema.metadata, ArrowCharView(METADATA_KEY), &value) !=
+          NANOARROW_OK ||
+      value.data == nullptr) {
+    return {};
+  }
+
+  try {
+    return Parse(string(value.data, static_cast<size_t>(value.size_bytes)));
+  } catch (std::exception&) {
+    // A declaration we don't understand is not an error, it just isn't used
+    return {};
+  }
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -5,6 +5,7 @@
 
 #include "ipc/stream_reader/ipc_buffer_stream_reader.hpp"
 #include "ipc/stream_reader/ipc_file_stream_reader.hpp"
+#include "ipc/stream_reader/ipc_socket_stream_reader.hpp"
 
 namespace duckdb {
 namespace ext_nanoarrow {
@@ -49,17 +50,48 @@ void BufferIPCStreamFactory::InitReader() {
   reader = make_uniq<IPCBufferStreamReader>(buffers, allocator);
 }
 
-FileIPCStreamFactory::FileIPCStreamFactory(ClientContext& context, string src_string)
+FileIPCStreamFactory::FileIPCStreamFactory(ClientContext& context, string src_string,
+                                           bool direct_io)
     : ArrowIPCStreamFactory(BufferAllocator::Get(context)),
       fs(FileSystem::GetFileSystem(context)),
-      src_string(std::move(src_string)) {}
+      src_string(std::move(src_string)),
+      direct_io(direct_io) {}
 
 void FileIPCStreamFactory::InitReader() {
   if (reader) {
     throw InternalException("ArrowArrayStream or IpcStreamReader already initialized");
   }
-  unique_ptr<FileHandle> handle = fs.OpenFile(src_string, FileOpenFlags::FILE_FLAGS_READ);
-  reader = make_uniq<IPCFileStreamReader>(fs, std::move(handle), allocator);
+  FileOpenFlags flags = FileOpenFlags::FILE_FLAGS_READ;
+  if (direct_io) {
+    flags = flags | FileOpenFlags::FILE_FLAGS_DIRECT_IO;
+  }
+  unique_ptr<FileHandle> handle = fs.OpenFile(src_string, flags);
+  reader = make_uniq<IPCFileStreamReader>(std::move(handle), allocator, direct_io);
+}
+
+SocketIPCStreamFactory::SocketIPCStreamFactory(ClientContext& context, string address)
+    : ArrowIPCStreamFactory(BufferAllocator::Get(context)),
+      context(context),
+      address(std::move(address)) {}
+
+void SocketIPCStreamFactory::InitReader() {
+  if (reader) {
+    throw InternalException("ArrowArrayStream or IpcStreamReader already initialized");
+  }
+  reader = make_uniq<IPCSocketStreamReader>(context, address, allocator);
+}
+
+SharedMemoryIPCStreamFactory::SharedMemoryIPCStreamFactory(
+    ClientContext& context, unique_ptr<SharedMemoryMapping> mapping)
+    : ArrowIPCStreamFactory(BufferAllocator::Get(context)), mapping(std::move(mapping)) {}
+
+void SharedMemoryIPCStreamFactory::InitReader() {
+  if (reader) {
+    throw InternalException("ArrowArrayStream or IpcStreamReader already initialized");
+  }
+  vector<ArrowIPCBuffer> buffers;
+  buffers.emplace_back(reinterpret_cast<uintptr_t>(mapping->Data()), mapping->Size());
+  reader = make_uniq<IPCBufferStreamReader>(std::move(buffers), allocator);
 }
 
 }  // namespace ext_nanoarrow
@@ -55,6 +55,8 @@ const ArrowSchema* IPCStreamReader::GetBaseSchema() {
   }
 
   ReadNextMessage({NANOARROW_IPC_MESSAGE_TYPE_SCHEMA}, /*end_of_stream_ok*/ false);
+  schema_message.assign(reinterpret_cast<const char*>(header_view.data.as_uint8),
+                        static_cast<idx_t>(header_view.size_bytes));
 
   if (decoder->feature_flags & NANOARROW_IPC_FEATURE_DICTIONARY_REPLACEMENT) {
     throw IOException("This stream uses unsupported feature DICTIONARY_REPLACEMENT");
@@ -64,13 +66,24 @@ const ArrowSchema* IPCStreamReader::GetBaseSchema() {
   THROW_NOT_OK(IOException, &error,
                ArrowIpcDecoderDecodeSchema(decoder.get(), base_schema.get(), &error));
 
+  InitializeDecoder();
+  return base_schema.get();
+}
+
+void IPCStreamReader::SetBaseSchema(const ArrowSchema* schema) {
+  if (base_schema->release) {
+    throw InternalException("IPCStreamReader base schema was already read");
+  }
+  NANOARROW_THROW_NOT_OK(ArrowSchemaDeepCopy(schema, base_schema.get()));
+  InitializeDecoder();
+}
+
+void IPCStreamReader::InitializeDecoder() {
   // Set up the decoder to decode batches
   THROW_NOT_OK(InternalException, &error,
                ArrowIpcDecoderSetEndianness(decoder.get(), decoder->endianness));
   THROW_NOT_OK(InternalException, &error,
                ArrowIpcDecoderSetSchema(decoder.get(), base_schema.get(), &error));
-
-  return base_schema.get();
 }
 
 bool IPCStreamReader::HasProjection() const { return !projected_fields.empty(); }
@@ -84,23 +97,130 @@ const ArrowSchema* IPCStreamReader::GetOutputSchema() {
 }
 
 bool IPCStreamReader::GetNextBatch(ArrowArray* out) {
+  if (!ReadMergedBatch(out)) {
+    return false;
+  }
+  if (convert_columns) {
+    ConvertColumns(*out);
+  }
+  return true;
+}
+
+void IPCStreamReader::ConvertColumns(ArrowArray& batch) {
+  if (!conversion_checked) {
+    conversion_kernels.clear();
+    has_conversion_kernels = false;
+    auto schema = GetOutputSchema();
+    for (int64_t i = 0; i < schema->n_children; i++) {
+      conversion_kernels.push_back(ArrowConversionKernel::Create(*schema->children[i]));
+      has_conversion_kernels = has_conversion_kernels || conversion_kernels.back();
+    }
+    conversion_checked = true;
+  }
+  if (has_conversion_kernels) {
+    ArrowConversionKernel::ConvertBatch(conversion_kernels, batch, allocator);
+  }
+}
+
+bool IPCStreamReader::ReadMergedBatch(ArrowArray* out) {
+  nanoarrow::UniqueArray batch;
+  if (pending_batch->release) {
+    ArrowArrayMove(pending_batch.get(), batch.get());
+  } else if (!ReadNextBatch(batch.get())) {
+    out->release = nullptr;
+    return false;
+  }
+  if (batch->length >= COALESCE_ROWS || !CanCoalesce()) {
+    ArrowArrayMove(batch.get(), out);
+    return true;
+  }
+
+  // Merge the small batches that follow until we have a full vector
+  ArrowBatchCoalescer coalescer(*GetOutputSchema());
+  coalescer.Append(*batch);
+  batch.reset();
+  while (coalescer.Length() < COALESCE_ROWS && ReadNextBatch(batch.get())) {
+    if (batch->length >= COALESCE_ROWS || !coalescer.Append(*batch)) {
+      // Returned as it is, after the merged batches
+      ArrowArrayMove(batch.get(), pending_batch.get());
+      break;
+    }
+    batch.reset();
+  }
+  coalescer.Finish(out);
+  return true;
+}
+
+bool IPCStreamReader::CanCoalesce() {
+  if (!coalesce_checked) {
+    coalesce_supported = ArrowBatchCoalescer::SupportsSchema(*GetOutputSchema());
+    coalesce_checked = true;
+  }
+  return coalesce_supported;
+}
+
+bool IPCStreamReader::ReadNextBatch(ArrowArray* out) {
   // When nanoarrow supports dictionary batches, we'd accept either a
   // RecordBatch or DictionaryBatch message, recording the dictionary batch
   // (or possibly ignoring it if it is for a field that we don't care about),
   // but looping until we end up with a RecordBatch in the decoder.
-  ArrowIpcMessageType message_type =
-      ReadNextMessage({NANOARROW_IPC_MESSAGE_TYPE_RECORD_BATCH});
-  if (message_type == NANOARROW_IPC_MESSAGE_TYPE_UNINITIALIZED) {
+  if (row_limit.IsValid() && rows_returned >= row_limit.GetIndex()) {
+    // We have returned enough rows, don't read any further
     out->release = nullptr;
     return false;
   }
+  if (NextBatchSlice(out)) {
+    ApplyRowLimit(out);
+    return true;
+  }
+
+  // Record batches that were skipped by a batch filter have no body, so we keep
+  // going until we find one that wasn't.
+  do {
+    ArrowIpcMessageType message_type =
+        ReadNextMessage({NANOARROW_IPC_MESSAGE_TYPE_RECORD_BATCH});
+    if (message_type == NANOARROW_IPC_MESSAGE_TYPE_UNINITIALIZED) {
+      out->release = nullptr;
+      return false;
+    }
+  } while (body_skipped);
+
+  if (NextBatchSlice(out)) {
+    ApplyRowLimit(out);
+    return true;
+  }
+
+  if (!cached_fields.empty()) {
+    nanoarrow::UniqueArray array;
+    ExportCachedBatch(array.get());
+    ApplyRowLimit(array.get());
+    ArrowArrayMove(array.get(), out);
+    return true;
+  }
+  bool cache_batch =
+      batch_cache && message_offset.IsValid() && batch_cache->IsActive();
 
   // Use the ArrowIpcSharedBuffer if we have thread safety (i.e., if this was
   // compiled with a compiler that supports C11 atomics, i.e., not gcc 4.8 or
-  // MSVC)
+  // MSVC). Every buffer of the decoded array, including the variadic data
+  // buffers of Utf8View/BinaryView columns, is then a slice of the message body
+  // that is kept alive by the shared buffer. DuckDB's Arrow scan turns those
+  // views into string_t values that point into these buffers, so string data
+  // is never copied on the way in.
   bool thread_safe_shared = ArrowIpcSharedBufferIsThreadSafe();
   struct ArrowBufferView body_view = AllocatedDataView(cur_ptr, cur_size);
-  nanoarrow::UniqueBuffer body_shared = GetUniqueBuffer();
+  nanoarrow::UniqueBuffer body_shared;
+  if (cache_batch && cur_size > 0) {
+    // The body may be a slice of a much larger read buffer, which the cache would
+    // keep alive. Cached batches get a copy of just their own body instead.
+    auto body_copy =
+        make_shared_ptr<AllocatedData>(allocator.Allocate(static_cast<idx_t>(cur_size)));
+    std::memcpy(body_copy->get(), cur_ptr, static_cast<size_t>(cur_size));
+    body_view = AllocatedDataView(body_copy->get(), cur_size);
+    body_shared = AllocatedDataToOwningBuffer(body_copy);
+  } else {
+    body_shared = GetUniqueBuffer();
+  }
   UniqueSharedBuffer shared;
   NANOARROW_THROW_NOT_OK(ArrowIpcSharedBufferInit(&shared.data, body_shared.get()));
   nanoarrow::UniqueArray array;
@@ -139,76 +259,59 @@ bool IPCStreamReader::GetNextBatch(ArrowArray* out) {
                                             NANOARROW_VALIDATION_LEVEL_FULL, &error));
   }
 
+  if (cache_batch) {
+    CacheBatch(array);
+  }
+  ApplyRowLimit(array.get());
   ArrowArrayMove(array.get(), out);
   return true;
 }
 
+void IPCStreamReader::ApplyRowLimit(ArrowArray* array) {
+  if (row_limit.IsValid()) {
+    // Slicing the batch is enough to keep the Arrow scan from converting the rest
+    auto remaining = static_cast<int64_t>(row_limit.GetIndex() - rows_returned);
+    array->length = MinValue<int64_t>(array->length, remaining);
+    rows_returned += static_cast<idx_t>(array->length);
+  }
+}
+
 void IPCStreamReader::SetColumnProjection(const vector<string>& column_names) {
   if (column_names.empty()) {
     throw InternalException("Can't request zero fields projected from IpcStreamReader");
   }
 
-  // Ensure we have a file schema to work with
-  GetBaseSchema();
+  // Only the projected columns are looked at, the rest of the schema was indexed
+  // once for all readers of the schema
+  auto& index = GetSchemaIndex();
+  coalesce_checked = false;
+  conversion_checked = false;
 
   nanoarrow::UniqueSchema schema;
   ArrowSchemaInit(schema.get());
   NANOARROW_THROW_NOT_OK(ArrowSchemaSetTypeStruct(
       schema.get(), UnsafeNumericCast<int64_t>(column_names.size())));
 
-  // The ArrowArray builder needs the flattened field index, which we need to
-  // keep track of.
-  unordered_map<string, pair<int64_t, const ArrowSchema*>> name_to_flat_field_map;
-
-  // Duplicate column names are in theory fine as long as they are not queried,
-  // so we need to make a list of them to check.
-  unordered_set<string> duplicate_column_names;
-
-  vector<string> names;
-  // Let's check if we need to deduplicate projection column names
-  for (idx_t col_idx = 0; col_idx < static_cast<idx_t>(base_schema->n_children);
-       col_idx++) {
-    if (base_schema->children[col_idx]->name) {
-      names.push_back(base_schema->children[col_idx]->name);
-    } else {
-      names.push_back("");
-    }
+  projected_fields.clear();
+  for (idx_t i = 0; i < column_names.size(); i++) {
+    auto column_idx = index.GetColumn(column_names[i]);
+    // The ArrowArray builder needs the flattened field index
+    projected_fields.push_back(index.column_fields[column_idx]);
+    NANOARROW_THROW_NOT_OK(ArrowSchemaDeepCopy(base_schema->children[column_idx],
+                                               schema->children[i]));
   }
-  QueryResult::DeduplicateColumns(names);
-  // Loop over columns to build the field map
-  int64_t field_count = 0;
-  for (int64_t i = 0; i < base_schema->n_children; i++) {
-    if (name_to_flat_field_map.find(names[i]) != name_to_flat_field_map.end()) {
-      duplicate_column_names.insert(names[i]);
-    }
-    name_to_flat_field_map.insert({names[i], {field_count, base_schema->children[i]}});
-    field_count += CountFields(base_schema->children[i]);
-  }
-
-  // Loop over projected column names to build the projection information
-  int64_t output_column_index = 0;
-  for (const auto& column_name : column_names) {
-    if (duplicate_column_names.find(column_name) != duplicate_column_names.end()) {
-      throw InternalException(string("Field '") + column_name +
-                              "' refers to a duplicate column name in IPC file schema");
-    }
-
-    auto field_id_item = name_to_flat_field_map.find(column_name);
-    if (field_id_item == name_to_flat_field_map.end()) {
-      throw InternalException(string("Field '") + column_name +
-                              "' does not exist in IPC file schema");
-    }
-
-    // Record the flat field index for this column
-    projected_fields.push_back(field_id_item->second.first);
-
-    // Record the Schema for this column
-    NANOARROW_THROW_NOT_OK(ArrowSchemaDeepCopy(field_id_item->second.second,
-                                               schema->children[output_column_index]));
+  projected_schema = std::move(schema);
+}
 
-    ++output_column_index;
+const IPCSchemaIndex& IPCStreamReader::GetSchemaIndex() {
+  if (!schema_index) {
+    schema_index = make_shared_ptr<IPCSchemaIndex>(*GetBaseSchema());
   }
-  projected_schema = std::move(schema);
+  return *schema_index;
+}
+
+void IPCStreamReader::SetSchemaIndex(shared_ptr<IPCSchemaIndex> index) {
+  schema_index = std::move(index);
 }
 
 idx_t IPCStreamReader::DecodeMetadata() const {
@@ -227,14 +330,139 @@ idx_t IPCStreamReader::DecodeMetadata() const {
 }
 
 ArrowIpcMessageType IPCStreamReader::DecodeMessage() {
+  body_skipped = false;
   auto message_header_size = DecodeMetadata();
   if (DecodeHeader(message_header_size)) {
     return NANOARROW_IPC_MESSAGE_TYPE_UNINITIALIZED;
   }
+  if (decoder->message_type == NANOARROW_IPC_MESSAGE_TYPE_RECORD_BATCH) {
+    bool skip = SkipCurrentBatch();
+    batch_count++;
+    if (skip) {
+      SkipBody();
+      cur_ptr = nullptr;
+      cur_size = 0;
+      body_skipped = true;
+      return decoder->message_type;
+    }
+    if (LookupCachedBatch()) {
+      // Everything we need was decoded before: the body isn't needed
+      SkipBody();
+      cur_ptr = nullptr;
+      cur_size = 0;
+      return decoder->message_type;
+    }
+  }
   DecodeBody();
   return decoder->message_type;
 }
 
+void IPCStreamReader::SetBatchCache(shared_ptr<ArrowBatchCache> cache,
+                                    ArrowBatchCacheFile file,
+                                    optional_ptr<atomic<idx_t>> cached_batches) {
+  batch_cache = std::move(cache);
+  batch_cache_file = std::move(file);
+  cached_batch_count = cached_batches;
+}
+
+bool IPCStreamReader::LookupCachedBatch() {
+  cached_fields.clear();
+  if (!batch_cache || !message_offset.IsValid() || !batch_cache->IsActive()) {
+    return false;
+  }
+
+  if (!HasProjection()) {
+    auto cached = batch_cache->Lookup(batch_cache_file, message_offset.GetIndex(), -1);
+    if (cached) {
+      cached_fields.push_back(std::move(cached));
+    }
+    return !cached_fields.empty();
+  }
+
+  for (const auto field : projected_fields) {
+    auto cached = batch_cache->Lookup(batch_cache_file, message_offset.GetIndex(), field);
+    if (!cached) {
+      // The body has to be read anyway, so we decode all of the fields again
+      cached_fields.clear();
+      return false;
+    }
+    cached_fields.push_back(std::move(cached));
+  }
+  return true;
+}
+
+void IPCStreamReader::ExportCachedBatch(ArrowArray* out) {
+  if (cached_batch_count) {
+    (*cached_batch_count)++;
+  }
+  if (!HasProjection()) {
+    CachedArrowArray::Export(std::move(cached_fields[0]), out);
+    cached_fields.clear();
+    return;
+  }
+
+  nanoarrow::UniqueArray array;
+  NANOARROW_THROW_NOT_OK(ArrowArrayInitFromType(array.get(), NANOARROW_TYPE_STRUCT));
+  NANOARROW_THROW_NOT_OK(ArrowArrayAllocateChildren(
+      array.get(), static_cast<int64_t>(cached_fields.size())));
+  for (idx_t i = 0; i < cached_fields.size(); i++) {
+    CachedArrowArray::Export(std::move(cached_fields[i]), array->children[i]);
+  }
+  cached_fields.clear();
+  array->length = array->children[0]->length;
+  array->null_count = 0;
+  ArrowArrayMove(array.get(), out);
+}
+
+void IPCStreamReader::CacheBatch(nanoarrow::UniqueArray& array) {
+  auto offset = message_offset.GetIndex();
+  if (!HasProjection()) {
+    auto size = CachedArrowArray::ArraySize(base_schema.get(), array.get());
+    auto cached = make_shared_ptr<CachedArrowArray>(array.get(), size);
+    batch_cache->Insert(batch_cache_file, offset, -1, cached);
+    CachedArrowArray::Export(std::move(cached), array.get());
+    return;
+  }
+
+  // Fields are cached one by one, so that queries that project different columns
+  // of the same file share the fields they have in common
+  for (int64_t i = 0; i < array->n_children; i++) {
+    auto size = CachedArrowArray::ArraySize(GetOutputSchema()->children[i],
+                                            array->children[i]);
+    auto cached = make_shared_ptr<CachedArrowArray>(array->children[i], size);
+    batch_cache->Insert(batch_cache_file, offset, projected_fields[i], cached);
+    CachedArrowArray::Export(std::move(cached), array->children[i]);
+  }
+}
+
+void IPCStreamReader::AddBatchFilter(unique_ptr<RecordBatchFilter> filter) {
+  batch_filters.push_back(std::move(filter));
+}
+
+bool IPCStreamReader::SkipCurrentBatch() {
+  if (batch_filters.empty()) {
+    return false;
+  }
+
+  IPCRecordBatchHeader header;
+  bool header_valid = false;
+  if (header_view.size_bytes > static_cast<int64_t>(sizeof(ArrowIpcMessagePrefix))) {
+    header_valid = IPCMetadata::DecodeRecordBatchHeader(
+        AllocatedDataView(header_view.data.as_uint8 + sizeof(ArrowIpcMessagePrefix),
+                          header_view.size_bytes -
+                              static_cast<int64_t>(sizeof(ArrowIpcMessagePrefix))),
+        header);
+  }
+
+  for (auto& filter : batch_filters) {
+    if (filter->SkipBatch(batch_count, message_offset,
+                          header_valid ? &header : nullptr)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 ArrowIpcMessageType IPCStreamReader::ReadNextMessage(
     vector<ArrowIpcMessageType> expected_types, bool end_of_stream_ok) {
   ArrowIpcMessageType actual_type = ReadNextMessage();
@@ -268,14 +496,6 @@ ArrowIpcMessageType IPCStreamReader::ReadNextMessage(
                     " Arrow IPC message but got " + actual_type_label);
 }
 
-int64_t IPCStreamReader::CountFields(const ArrowSchema* schema) {
-  int64_t n_fields = 1;
-  for (int64_t i = 0; i < schema->n_children; i++) {
-    n_fields += CountFields(schema->children[i]);
-  }
-  return n_fields;
-}
-
 ArrowBufferView IPCStreamReader::AllocatedDataView(const_data_ptr_t data, int64_t size) {
   ArrowBufferView view{};
   view.data.data = data;
@@ -33,8 +33,20 @@ ArrowIpcMessageType IPCBufferStreamReader::ReadNextMessage() {
   return DecodeMessage();
 }
 
+void IPCBufferStreamReader::SetBuffers(vector<ArrowIPCBuffer> buffers_p) {
+  buffers = std::move(buffers_p);
+  cur_idx = 0;
+  cur_buffer = IPCBuffer();
+  initialized = false;
+  finished = false;
+}
+
 data_ptr_t IPCBufferStreamReader::ReadData(data_ptr_t ptr, idx_t size) {
-  D_ASSERT(size + cur_buffer.pos < cur_buffer.size);
+  // Buffers can come from another process (e.g., shared memory), so a truncated
+  // stream must not be read past its end
+  if (cur_buffer.pos + size > static_cast<idx_t>(cur_buffer.size)) {
+    throw IOException("Arrow IPC buffer ends in the middle of a message");
+  }
   data_ptr_t cur_ptr = cur_buffer.ptr + cur_buffer.pos;
   cur_buffer.pos += size;
   return cur_ptr;
@@ -45,6 +57,7 @@ bool IPCBufferStreamReader::DecodeHeader(idx_t message_header_size) {
   header.ptr =
       ReadData(header.ptr, message_prefix.metadata_size) - sizeof(message_prefix);
   header.size = message_header_size;
+  header_view = AllocatedDataView(header.ptr, header.size);
   const ArrowErrorCode decode_header_status = ArrowIpcDecoderDecodeHeader(
       decoder.get(), AllocatedDataView(header.ptr, header.size), &error);
   if (decode_header_status == ENODATA) {
@@ -58,6 +71,13 @@ bool IPCBufferStreamReader::DecodeHeader(idx_t message_header_size) {
 void IPCBufferStreamReader::DecodeBody() {
   if (decoder->body_size_bytes > 0) {
     body.ptr = ReadData(body.ptr, decoder->body_size_bytes);
+    // The wrapped body must report its real size: view columns reference
+    // variadic buffers anywhere in the body, and those slices are validated
+    // against the size of the shared buffer.
+    body.size = decoder->body_size_bytes;
+  } else {
+    body.ptr = nullptr;
+    body.size = 0;
   }
   if (body.ptr) {
     cur_ptr = body.ptr;
@@ -68,6 +88,14 @@ void IPCBufferStreamReader::DecodeBody() {
   }
 }
 
+void IPCBufferStreamReader::SkipBody() {
+  if (decoder->body_size_bytes > 0) {
+    ReadData(nullptr, decoder->body_size_bytes);
+  }
+  body.ptr = nullptr;
+  body.size = 0;
+}
+
 nanoarrow::UniqueBuffer IPCBufferStreamReader::GetUniqueBuffer() {
   nanoarrow::UniqueBuffer out;
   nanoarrow::BufferInitWrapped(out.get(), body, body.ptr, body.size);
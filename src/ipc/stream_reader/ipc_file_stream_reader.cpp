@@ -1,11 +1,36 @@
 #include "ipc/stream_reader/ipc_file_stream_reader.hpp"
 #include "duckdb/common/file_system.hpp"
+#include "duckdb/common/types/interval.hpp"
+#include "duckdb/common/types/timestamp.hpp"
 
 namespace duckdb {
 namespace ext_nanoarrow {
-IPCFileStreamReader::IPCFileStreamReader(FileSystem& fs, unique_ptr<FileHandle> handle,
-                                         Allocator& allocator)
-    : IPCStreamReader(allocator), file_reader(fs, std::move(handle)) {}
+
+namespace {
+
+//! Makes the offsets of a slice of a variable-size binary column start at zero and
+//! returns the range of the data buffer they refer to
+template <class T>
+void RebaseOffsets(AllocatedData& offsets, int64_t count, int64_t& data_start,
+                   int64_t& data_end) {
+  auto data = reinterpret_cast<T*>(offsets.get());
+  data_start = static_cast<int64_t>(data[0]);
+  data_end = static_cast<int64_t>(data[count]);
+  if (data_start < 0 || data_end < data_start) {
+    throw IOException("Invalid offsets in Arrow IPC record batch");
+  }
+  for (int64_t i = 0; i <= count; i++) {
+    data[i] = static_cast<T>(data[i] - data_start);
+  }
+}
+
+}  // namespace
+
+IPCFileStreamReader::IPCFileStreamReader(unique_ptr<FileHandle> handle,
+                                         Allocator& allocator, bool direct_io,
+                                         idx_t read_ahead_size)
+    : IPCStreamReader(allocator),
+      file_reader(std::move(handle), allocator, direct_io, read_ahead_size) {}
 
 void IPCFileStreamReader::PopulateNames(vector<string>& names) {
   GetBaseSchema();
@@ -28,6 +53,177 @@ double IPCFileStreamReader::GetProgress() {
   return (current_offset / static_cast<double>(file_size)) * 100;
 }
 
+bool IPCFileStreamReader::ReadFooterBlocks(vector<IPCFileBlock>& blocks) {
+  // The file ends with the footer flatbuffer, its size as int32 and "ARROW1"
+  static constexpr idx_t kTrailerSize = sizeof(int32_t) + 6;
+  GetBaseSchema();
+  idx_t file_size = file_reader.FileSize();
+  if (!has_file_magic || file_size < 8 + kTrailerSize) {
+    return false;
+  }
+
+  idx_t current_offset = file_reader.CurrentOffset();
+  file_reader.PrefetchTail(TAIL_READ_SIZE);
+  char trailer[kTrailerSize];
+  file_reader.Seek(file_size - kTrailerSize);
+  file_reader.ReadData(reinterpret_cast<data_ptr_t>(trailer), kTrailerSize);
+  int32_t footer_size;
+  std::memcpy(&footer_size, trailer, sizeof(int32_t));
+  if (std::memcmp(trailer + sizeof(int32_t), "ARROW1", 6) != 0 || footer_size <= 0 ||
+      static_cast<idx_t>(footer_size) > file_size - 8 - kTrailerSize) {
+    file_reader.Seek(current_offset);
+    return false;
+  }
+
+  auto footer = allocator.Allocate(static_cast<idx_t>(footer_size));
+  file_reader.Seek(file_size - kTrailerSize - static_cast<idx_t>(footer_size));
+  file_reader.ReadData(footer.get(), static_cast<idx_t>(footer_size));
+  file_reader.Seek(current_offset);
+  return IPCMetadata::DecodeFooterBlocks(AllocatedDataView(footer.get(), footer_size),
+                                         blocks);
+}
+
+unique_ptr<ArrowFileStatistics> IPCFileStreamReader::ReadStatistics() {
+  static constexpr idx_t kTrailerSize = ArrowFileStatistics::TRAILER_SIZE;
+  idx_t file_size = file_reader.FileSize();
+  if (file_size < 8 + kTrailerSize) {
+    return nullptr;
+  }
+
+  idx_t current_offset = file_reader.CurrentOffset();
+  file_reader.PrefetchTail(TAIL_READ_SIZE);
+  char trailer[kTrailerSize];
+  file_reader.Seek(file_size - kTrailerSize);
+  file_reader.ReadData(reinterpret_cast<data_ptr_t>(trailer), kTrailerSize);
+  uint64_t statistics_size;
+  std::memcpy(&statistics_size, trailer, sizeof(uint64_t));
+  if (std::memcmp(trailer + sizeof(uint64_t), ArrowFileStatistics::TRAILER_MAGIC,
+                  ArrowFileStatistics::TRAILER_MAGIC_SIZE) != 0 ||
+      statistics_size == 0 || statistics_size > file_size - 8 - kTrailerSize) {
+    file_reader.Seek(current_offset);
+    return nullptr;
+  }
+
+  auto statistics = allocator.Allocate(statistics_size);
+  file_reader.Seek(file_size - kTrailerSize - statistics_size);
+  file_reader.ReadData(statistics.get(), statistics_size);
+  file_reader.Seek(current_offset);
+  return ArrowFileStatistics::Read(statistics.get(), statistics_size);
+}
+
+bool IPCFileStreamReader::CountRows(idx_t max_batches, idx_t& row_count,
+                                    bool& exact) {
+  GetBaseSchema();
+  if (has_file_magic && CountFooterRows(row_count, exact)) {
+    return true;
+  }
+  idx_t data_start = file_reader.CurrentOffset();
+
+  auto filter = make_uniq<RowCountFilter>();
+  auto& counter = *filter;
+  AddBatchFilter(std::move(filter));
+  while (counter.batch_count < max_batches &&
+         ReadNextMessage() != NANOARROW_IPC_MESSAGE_TYPE_UNINITIALIZED) {
+  }
+  if (!counter.valid) {
+    return false;
+  }
+
+  row_count = counter.row_count;
+  exact = finished;
+  idx_t data_read = file_reader.CurrentOffset() - data_start;
+  if (!exact && data_read > 0) {
+    auto data_size = static_cast<double>(file_reader.FileSize() - data_start);
+    row_count = static_cast<idx_t>(static_cast<double>(row_count) * data_size /
+                                   static_cast<double>(data_read));
+  }
+  return true;
+}
+
+bool IPCFileStreamReader::CountFooterRows(idx_t& row_count, bool& exact) {
+  vector<IPCFileBlock> blocks;
+  if (!ReadFooterBlocks(blocks)) {
+    return false;
+  }
+  row_count = 0;
+  exact = blocks.size() <= 1;
+  if (blocks.empty()) {
+    return true;
+  }
+  // The first header is in the window of the schema, the footer lists the others
+  idx_t first_rows;
+  if (!ReadBlockRowCount(blocks[0], first_rows)) {
+    return false;
+  }
+  idx_t total_size = 0;
+  for (const auto& block : blocks) {
+    total_size += static_cast<idx_t>(block.metadata_length) +
+                  static_cast<idx_t>(block.body_length);
+  }
+  auto first_size = static_cast<idx_t>(blocks[0].metadata_length) +
+                    static_cast<idx_t>(blocks[0].body_length);
+  row_count = first_rows;
+  if (!exact && first_size > 0) {
+    row_count = static_cast<idx_t>(static_cast<double>(first_rows) *
+                                   static_cast<double>(total_size) /
+                                   static_cast<double>(first_size));
+  }
+  return true;
+}
+
+bool IPCFileStreamReader::ReadBlockRowCount(const IPCFileBlock& block,
+                                            idx_t& row_count) {
+  static constexpr idx_t kPrefixSize = sizeof(ArrowIpcMessagePrefix);
+  if (block.offset < 0 || block.metadata_length <= static_cast<int32_t>(kPrefixSize) ||
+      static_cast<idx_t>(block.offset) + static_cast<idx_t>(block.metadata_length) >
+          file_reader.FileSize()) {
+    return false;
+  }
+  auto metadata_size = static_cast<idx_t>(block.metadata_length);
+  auto metadata = allocator.Allocate(metadata_size);
+  idx_t current_offset = file_reader.CurrentOffset();
+  file_reader.Seek(static_cast<idx_t>(block.offset));
+  file_reader.ReadData(metadata.get(), metadata_size);
+  file_reader.Seek(current_offset);
+
+  ArrowIpcMessagePrefix prefix;
+  std::memcpy(&prefix, metadata.get(), kPrefixSize);
+  IPCRecordBatchHeader header;
+  if (prefix.continuation_token != 0xFFFFFFFF ||
+      !IPCMetadata::DecodeRecordBatchHeader(
+          AllocatedDataView(metadata.get() + kPrefixSize,
+                            static_cast<int64_t>(metadata_size - kPrefixSize)),
+          header) ||
+      header.length < 0) {
+    return false;
+  }
+  row_count = static_cast<idx_t>(header.length);
+  return true;
+}
+
+ArrowBatchCacheFile IPCFileStreamReader::GetCacheFile() {
+  auto& handle = file_reader.GetHandle();
+  ArrowBatchCacheFile file;
+  file.path = handle.GetPath();
+  auto last_modified = handle.file_system.GetLastModifiedTime(handle);
+  file.last_modified = static_cast<int64_t>(last_modified);
+  file.file_size = file_reader.FileSize();
+  auto now = Timestamp::GetEpochMicroSeconds(Timestamp::GetCurrentTimestamp());
+  file.recently_modified =
+      now - Timestamp::GetEpochMicroSeconds(last_modified) <
+      ArrowBatchCacheFile::RACY_MODIFICATION_SECONDS * Interval::MICROS_PER_SEC;
+  return file;
+}
+
+void IPCFileStreamReader::SetReadRange(idx_t start, idx_t end) {
+  if (!base_schema->release) {
+    throw InternalException(
+        "IPCFileStreamReader::SetReadRange called before the schema was read");
+  }
+  file_reader.SetRange(start, end);
+  finished = false;
+}
+
 void IPCFileStreamReader::DecodeArray(nanoarrow::ipc::UniqueDecoder& decoder,
                                       ArrowArray* out, ArrowBufferView& body_view,
                                       ArrowError* error) {
@@ -42,19 +238,24 @@ void IPCFileStreamReader::DecodeArray(nanoarrow::ipc::UniqueDecoder& decoder,
 }
 
 nanoarrow::UniqueBuffer IPCFileStreamReader::GetUniqueBuffer() {
-  return AllocatedDataToOwningBuffer(message_body);
+  nanoarrow::UniqueBuffer out;
+  if (message_body.owner) {
+    nanoarrow::BufferInitWrapped(out.get(), message_body.owner, message_body.ptr,
+                                 static_cast<int64_t>(message_body.size));
+  }
+  return out;
 }
 bool IPCFileStreamReader::DecodeHeader(const idx_t message_header_size) {
   if (message_header.GetSize() < message_header_size) {
     message_header = allocator.Allocate(message_header_size);
   }
-  // Read the message header. I believe the fact that this loops and calls
-  // the file handle's Read() method with relatively small chunks will ensure that
-  // an attempt to read a very large message_header_size can be cancelled. If this
-  // is not the case, we might want to implement our own buffering.
+  // Read the message header. This is almost always served from the read-ahead
+  // window that was filled when reading the message prefix.
   std::memcpy(message_header.get(), &message_prefix, sizeof(message_prefix));
   ReadData(message_header.get() + sizeof(message_prefix), message_prefix.metadata_size);
 
+  header_view = AllocatedDataView(message_header.get(),
+                                  static_cast<int64_t>(message_header_size));
   ArrowErrorCode decode_header_status = ArrowIpcDecoderDecodeHeader(
       decoder.get(),
       AllocatedDataView(message_header.get(),
@@ -69,23 +270,185 @@ bool IPCFileStreamReader::DecodeHeader(const idx_t message_header_size) {
 }
 
 void IPCFileStreamReader::DecodeBody() {
+  sliced_batch.reset();
+  message_body = ReadBufferSlice();
+  if (decoder->body_size_bytes > 0) {
+    if (!EnsureInputStreamAligned()) {
+      throw IOException("Unexpected end of file while reading Arrow IPC message body");
+    }
+    // Slices are read at their offsets, which sources that can't seek don't allow
+    if (decoder->message_type == NANOARROW_IPC_MESSAGE_TYPE_RECORD_BATCH &&
+        sliced_body_size > 0 &&
+        static_cast<idx_t>(decoder->body_size_bytes) >= sliced_body_size &&
+        file_reader.IsSeekable() && StartSlicedBatch()) {
+      // The slices are read as the scan asks for them
+      if (sliced_batch_count) {
+        (*sliced_batch_count)++;
+      }
+      file_reader.Skip(decoder->body_size_bytes);
+      cur_ptr = nullptr;
+      cur_size = 0;
+      return;
+    }
+    // The body is a slice of the read-ahead window if it fits there, so that
+    // the bodies of the next few messages are fetched with a single read.
+    message_body = file_reader.ReadBuffer(decoder->body_size_bytes);
+  }
+  cur_ptr = message_body.ptr;
+  cur_size = static_cast<int64_t>(message_body.size);
+}
+
+void IPCFileStreamReader::SkipBody() {
+  sliced_batch.reset();
+  message_body = ReadBufferSlice();
   if (decoder->body_size_bytes > 0) {
-    EnsureInputStreamAligned();
-    message_body =
-        make_shared_ptr<AllocatedData>(allocator.Allocate(decoder->body_size_bytes));
+    if (!EnsureInputStreamAligned()) {
+      throw IOException("Unexpected end of file while skipping Arrow IPC message body");
+    }
+    file_reader.Skip(decoder->body_size_bytes);
+  }
+}
+
+bool IPCFileStreamReader::StartSlicedBatch() {
+  IPCRecordBatchHeader header;
+  if (header_view.size_bytes <= static_cast<int64_t>(sizeof(ArrowIpcMessagePrefix)) ||
+      !IPCMetadata::DecodeRecordBatchHeader(
+          AllocatedDataView(header_view.data.as_uint8 + sizeof(ArrowIpcMessagePrefix),
+                            header_view.size_bytes -
+                                static_cast<int64_t>(sizeof(ArrowIpcMessagePrefix))),
+          header) ||
+      header.compressed || header.length <= 0) {
+    return false;
+  }
+
+  // Locate the nodes and buffers of the output columns in the body
+  auto& index = GetSchemaIndex();
+  if (index.field_buffers.empty() ||
+      static_cast<int64_t>(header.buffers.size()) != index.buffer_count ||
+      header.nodes.size() != index.field_buffers.size()) {
+    return false;
+  }
+  const auto& column_fields = HasProjection() ? projected_fields : index.column_fields;
+
+  auto batch = make_uniq<SlicedBatch>();
+  auto output_schema = GetOutputSchema();
+  int64_t bytes = 0;
+  for (int64_t i = 0; i < output_schema->n_children; i++) {
+    // Only flat columns: fixed-width (including booleans) and variable-size binary
+    SlicedColumn column;
+    if (!ArrowFlatLayout::Get(*output_schema->children[i], column.layout)) {
+      return false;
+    }
+
+    auto field_idx = static_cast<idx_t>(column_fields[i]);
+    column.node = header.nodes[field_idx];
+    if (column.node.length != header.length) {
+      return false;
+    }
+    for (idx_t j = 0; j < column.layout.BufferCount(); j++) {
+      auto buffer_idx = static_cast<idx_t>(index.field_buffers[field_idx]) + j;
+      auto& buffer = header.buffers[buffer_idx];
+      column.buffers.push_back(buffer);
+      bytes += buffer.length;
+    }
+    batch->columns.push_back(std::move(column));
+  }
+
+  auto bytes_per_row = MaxValue<int64_t>(bytes / header.length, 1);
+  auto rows_per_slice = static_cast<int64_t>(SLICE_SIZE) / bytes_per_row;
+  batch->rows_per_slice =
+      MaxValue<int64_t>(rows_per_slice / STANDARD_VECTOR_SIZE, 1) * STANDARD_VECTOR_SIZE;
+  batch->body_start = file_reader.CurrentOffset();
+  batch->length = header.length;
+  batch->next_row = 0;
+  sliced_batch = std::move(batch);
+  return true;
+}
 
-    // Again, this is possibly a long running Read() call for a large body.
-    // We could possibly be smarter about how we do this, particularly if we
-    // are reading a small portion of the input from a seekable file.
-    ReadData(message_body->get(), decoder->body_size_bytes);
+shared_ptr<AllocatedData> IPCFileStreamReader::ReadSliceRange(
+    const IPCBodyBuffer& buffer, int64_t start, int64_t end) {
+  if (start < 0 || end < start || end > buffer.length) {
+    throw IOException(
+        "Arrow IPC record batch buffer of %d bytes is too small for its rows",
+        buffer.length);
   }
-  if (message_body) {
-    cur_ptr = message_body->get();
-    cur_size = static_cast<int64_t>(message_body->GetSize());
-  } else {
-    cur_ptr = nullptr;
-    cur_size = 0;
+  auto size = static_cast<idx_t>(end - start);
+  // The allocator is the buffer allocator of the database, whose allocations are
+  // reserved with the buffer manager: it evicts blocks to make room and throws an
+  // OutOfMemoryException if the slice doesn't fit in memory_limit
+  auto data = make_shared_ptr<AllocatedData>(allocator.Allocate(size));
+  if (size > 0) {
+    file_reader.Seek(sliced_batch->body_start +
+                     static_cast<idx_t>(buffer.offset + start));
+    file_reader.ReadData(data->get(), size);
   }
+  return data;
+}
+
+bool IPCFileStreamReader::NextBatchSlice(ArrowArray* out) {
+  if (!sliced_batch) {
+    return false;
+  }
+  auto& batch = *sliced_batch;
+  auto start = batch.next_row;
+  auto end = MinValue<int64_t>(start + batch.rows_per_slice, batch.length);
+  auto count = end - start;
+
+  nanoarrow::UniqueArray array;
+  THROW_NOT_OK(InternalException, &error,
+               ArrowArrayInitFromSchema(array.get(), GetOutputSchema(), &error));
+  auto set_buffer = [](ArrowArray* child, int64_t i,
+                       const shared_ptr<AllocatedData>& data) {
+    auto buffer = AllocatedDataToOwningBuffer(data);
+    NANOARROW_THROW_NOT_OK(ArrowArraySetBuffer(child, i, buffer.get()));
+  };
+
+  // The body was skipped, the slices are read from where it was
+  idx_t current_offset = file_reader.CurrentOffset();
+  for (idx_t i = 0; i < batch.columns.size(); i++) {
+    auto& column = batch.columns[i];
+    auto child = array->children[i];
+    child->length = count;
+    child->null_count = 0;
+    if (column.node.null_count != 0 && column.buffers[0].length > 0) {
+      set_buffer(child, 0, ReadSliceRange(column.buffers[0], start / 8, (end + 7) / 8));
+      child->null_count = -1;
+    }
+
+    auto value_bits = column.layout.value_bits;
+    if (!column.layout.variable_size) {
+      auto values = value_bits == 1
+                        ? ReadSliceRange(column.buffers[1], start / 8, (end + 7) / 8)
+                        : ReadSliceRange(column.buffers[1], start * value_bits / 8,
+                                         end * value_bits / 8);
+      set_buffer(child, 1, values);
+      continue;
+    }
+    auto offset_size = value_bits / 8;
+    auto offsets =
+        ReadSliceRange(column.buffers[1], start * offset_size, (end + 1) * offset_size);
+    int64_t data_start, data_end;
+    if (offset_size == 4) {
+      RebaseOffsets<int32_t>(*offsets, count, data_start, data_end);
+    } else {
+      RebaseOffsets<int64_t>(*offsets, count, data_start, data_end);
+    }
+    set_buffer(child, 1, offsets);
+    set_buffer(child, 2, ReadSliceRange(column.buffers[2], data_start, data_end));
+  }
+  file_reader.Seek(current_offset);
+
+  array->length = count;
+  array->null_count = 0;
+  THROW_NOT_OK(InternalException, &error,
+               ArrowArrayFinishBuilding(array.get(), NANOARROW_VALIDATION_LEVEL_DEFAULT,
+                                        &error));
+  batch.next_row = end;
+  if (batch.next_row >= batch.length) {
+    sliced_batch.reset();
+  }
+  ArrowArrayMove(array.get(), out);
+  return true;
 }
 
 data_ptr_t IPCFileStreamReader::ReadData(data_ptr_t ptr, idx_t size) {
@@ -99,45 +462,45 @@ ArrowIpcMessageType IPCFileStreamReader::ReadNextMessage() {
   }
 
   // If there is no more data to be read, we're done!
-  try {
-    EnsureInputStreamAligned();
-    file_reader.ReadData(reinterpret_cast<data_ptr_t>(&message_prefix),
-                         sizeof(message_prefix));
-
-    // If we're at the beginning of the read, and we see the Arrow file format
-    // header bytes, skip them and try to read the stream anyway. This works because
-    // there's a full stream within an Arrow file (including the EOS indicator, which
-    // is key to success. This EOS indicator is unfortunately missing in Rust releases
-    // prior to ~September 2024).
-    //
-    // When we support dictionary encoding we will possibly need to seek to the footer
-    // here, parse that, and maybe lazily seek and read dictionaries for if/when they are
-    // required.
-    if (file_reader.CurrentOffset() == 8 &&
-        std::memcmp("ARROW1\0\0", &message_prefix, 8) == 0) {
-      return ReadNextMessage();
-    }
-
-    if (message_prefix.continuation_token != kContinuationToken) {
-      throw IOException(std::string("Expected continuation token (0xFFFFFFFF) but got " +
-                                    std::to_string(message_prefix.continuation_token)));
-    }
-
-  } catch (SerializationException& e) {
+  if (!EnsureInputStreamAligned() || file_reader.Exhausted(sizeof(message_prefix))) {
     finished = true;
     return NANOARROW_IPC_MESSAGE_TYPE_UNINITIALIZED;
   }
+  message_offset = file_reader.CurrentOffset();
+  file_reader.ReadData(reinterpret_cast<data_ptr_t>(&message_prefix),
+                       sizeof(message_prefix));
+
+  // If we're at the beginning of the read, and we see the Arrow file format
+  // header bytes, skip them and try to read the stream anyway. This works because
+  // there's a full stream within an Arrow file (including the EOS indicator, which
+  // is key to success. This EOS indicator is unfortunately missing in Rust releases
+  // prior to ~September 2024).
+  //
+  // When we support dictionary encoding we will possibly need to seek to the footer
+  // here, parse that, and maybe lazily seek and read dictionaries for if/when they are
+  // required.
+  if (file_reader.CurrentOffset() == 8 &&
+      std::memcmp("ARROW1\0\0", &message_prefix, 8) == 0) {
+    has_file_magic = true;
+    return ReadNextMessage();
+  }
+
+  if (message_prefix.continuation_token != kContinuationToken) {
+    throw IOException(std::string("Expected continuation token (0xFFFFFFFF) but got " +
+                                  std::to_string(message_prefix.continuation_token)));
+  }
 
   return DecodeMessage();
 }
 
-void IPCFileStreamReader::EnsureInputStreamAligned() {
-  uint8_t padding[8];
-  int padding_bytes = 8 - (file_reader.CurrentOffset() % 8);
-  if (padding_bytes != 8) {
-    file_reader.ReadData(padding, padding_bytes);
+bool IPCFileStreamReader::EnsureInputStreamAligned() {
+  idx_t padding_bytes = (8 - (file_reader.CurrentOffset() % 8)) % 8;
+  if (file_reader.Exhausted(padding_bytes)) {
+    return false;
   }
+  file_reader.Skip(padding_bytes);
   D_ASSERT((file_reader.CurrentOffset() % 8) == 0);
+  return true;
 }
 
 }  // namespace ext_nanoarrow
@@ -0,0 +1,338 @@
+#include "ipc/stream_reader/ipc_socket_stream_reader.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "duckdb/common/error_data.hpp"
+#include "duckdb/common/string_util.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+constexpr const char* UNIX_PREFIX = "unix://";
+constexpr const char* TCP_PREFIX = "tcp://";
+
+#ifndef _WIN32
+int ConnectUnix(const string& address, const string& path) {
+  sockaddr_un socket_address{};
+  if (path.empty() || path.size() >= sizeof(socket_address.sun_path)) {
+    throw InvalidInputException("Invalid Unix domain socket path in \"%s\"", address);
+  }
+  socket_address.sun_family = AF_UNIX;
+  std::memcpy(socket_address.sun_path, path.c_str(), path.size());
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    throw IOException("Could not create a socket for \"%s\": %s", address,
+                      strerror(errno));
+  }
+  if (connect(fd, reinterpret_cast<sockaddr*>(&socket_address),
+              sizeof(socket_address)) != 0) {
+    auto connect_error = errno;
+    close(fd);
+    throw IOException("Could not connect to \"%s\": %s", address,
+                      strerror(connect_error));
+  }
+  return fd;
+}
+
+int ConnectTCP(const string& address, const string& host_and_port) {
+  auto separator = host_and_port.rfind(':');
+  if (separator == string::npos || separator == 0 ||
+      separator + 1 == host_and_port.size()) {
+    throw InvalidInputException("Expected tcp://host:port but got \"%s\"", address);
+  }
+  auto host = host_and_port.substr(0, separator);
+  auto port = host_and_port.substr(separator + 1);
+  if (host.size() > 2 && host.front() == '[' && host.back() == ']') {
+    // IPv6 address
+    host = host.substr(1, host.size() - 2);
+  }
+
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* addresses = nullptr;
+  auto status = getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses);
+  if (status != 0) {
+    throw IOException("Could not resolve \"%s\": %s", address, gai_strerror(status));
+  }
+  int fd = -1;
+  int connect_error = 0;
+  for (auto entry = addresses; entry; entry = entry->ai_next) {
+    fd = socket(entry->ai_family, entry->ai_socktype, entry->ai_protocol);
+    if (fd < 0) {
+      connect_error = errno;
+      continue;
+    }
+    if (connect(fd, entry->ai_addr, entry->ai_addrlen) == 0) {
+      break;
+    }
+    connect_error = errno;
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+  if (fd < 0) {
+    throw IOException("Could not connect to \"%s\": %s", address,
+                      strerror(connect_error));
+  }
+  return fd;
+}
+#endif
+
+}  // namespace
+
+IPCSocketStreamReader::IPCSocketStreamReader(ClientContext& context,
+                                             string address_p, Allocator& allocator)
+    : IPCStreamReader(allocator), context(context), address(std::move(address_p)) {
+#ifdef _WIN32
+  throw NotImplementedException("Reading Arrow IPC streams from sockets (\"%s\") is not "
+                                "supported on Windows",
+                                address);
+#else
+  if (StringUtil::StartsWith(address, UNIX_PREFIX)) {
+    socket_fd = ConnectUnix(address, address.substr(strlen(UNIX_PREFIX)));
+  } else if (StringUtil::StartsWith(address, TCP_PREFIX)) {
+    socket_fd = ConnectTCP(address, address.substr(strlen(TCP_PREFIX)));
+  } else {
+    throw InternalException("\"%s\" is not a socket address", address);
+  }
+  receiver = std::thread([this]() { ReceiveBlocks(); });
+#endif
+}
+
+IPCSocketStreamReader::~IPCSocketStreamReader() {
+#ifndef _WIN32
+  {
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+  }
+  block_consumed.notify_all();
+  if (socket_fd >= 0) {
+    // Wakes up the receiver if it waits for data
+    shutdown(socket_fd, SHUT_RDWR);
+  }
+  if (receiver.joinable()) {
+    receiver.join();
+  }
+  if (socket_fd >= 0) {
+    close(socket_fd);
+  }
+#endif
+}
+
+bool IPCSocketStreamReader::IsSocketAddress(const string& source) {
+  return StringUtil::StartsWith(source, UNIX_PREFIX) ||
+         StringUtil::StartsWith(source, TCP_PREFIX);
+}
+
+void IPCSocketStreamReader::ReceiveBlocks() {
+#ifndef _WIN32
+  // Reused for the receives that return few bytes, which are copied into a block of
+  // their size
+  AllocatedData buffer;
+  while (true) {
+    {
+      unique_lock<mutex> guard(lock);
+      block_consumed.wait(
+          guard, [&]() { return stopping || received_size < MAX_RECEIVED_SIZE; });
+      if (stopping) {
+        return;
+      }
+    }
+    try {
+      if (!buffer.get()) {
+        buffer = allocator.Allocate(RECEIVE_BLOCK_SIZE);
+      }
+    } catch (std::exception& ex) {
+      // Raised by the scan, this thread must not throw
+      lock_guard<mutex> guard(lock);
+      receive_error = ErrorData(ex).RawMessage();
+      end_of_stream = true;
+      block_received.notify_all();
+      return;
+    }
+    ssize_t size;
+    do {
+      size = recv(socket_fd, buffer.get(), RECEIVE_BLOCK_SIZE, 0);
+    } while (size < 0 && errno == EINTR);
+    auto receive_errno = errno;
+
+    AllocatedData block;
+    if (size >= static_cast<ssize_t>(RECEIVE_BLOCK_SIZE / 2)) {
+      block = std::move(buffer);
+    } else if (size > 0) {
+      try {
+        block = allocator.Allocate(static_cast<idx_t>(size));
+      } catch (std::exception& ex) {
+        lock_guard<mutex> guard(lock);
+        receive_error = ErrorData(ex).RawMessage();
+        end_of_stream = true;
+        block_received.notify_all();
+        return;
+      }
+      std::memcpy(block.get(), buffer.get(), static_cast<idx_t>(size));
+    }
+
+    lock_guard<mutex> guard(lock);
+    if (size <= 0) {
+      if (size < 0 && !stopping) {
+        receive_error = strerror(receive_errno);
+      }
+      end_of_stream = true;
+      block_received.notify_all();
+      return;
+    }
+    received_size += static_cast<idx_t>(size);
+    blocks.push_back({std::move(block), static_cast<idx_t>(size)});
+    block_received.notify_all();
+  }
+#endif
+}
+
+bool IPCSocketStreamReader::Receive(data_ptr_t ptr, idx_t size) {
+  idx_t done = 0;
+  unique_lock<mutex> guard(lock);
+  while (done < size) {
+    // A peer that stays connected without sending must not keep the query from
+    // being cancelled
+    while (!block_received.wait_for(
+        guard, std::chrono::milliseconds(INTERRUPT_CHECK_MS),
+        [&]() { return !blocks.empty() || end_of_stream; })) {
+      if (context.interrupted) {
+        throw InterruptException();
+      }
+    }
+    if (blocks.empty()) {
+      if (!receive_error.empty()) {
+        throw IOException("Could not read Arrow IPC stream from \"%s\": %s", address,
+                          receive_error);
+      }
+      if (done == 0) {
+        return false;
+      }
+      throw IOException("Arrow IPC stream from \"%s\" ended in the middle of a message",
+                        address);
+    }
+    // Only this thread removes blocks, so the first one stays put while the
+    // receiver appends blocks behind it
+    auto& block = blocks.front();
+    auto count = MinValue<idx_t>(size - done, block.size - block_offset);
+    auto source = block.data.get() + block_offset;
+    guard.unlock();
+    if (ptr) {
+      std::memcpy(ptr + done, source, count);
+    }
+    guard.lock();
+    done += count;
+    block_offset += count;
+    stream_offset += count;
+    if (block_offset == block.size) {
+      received_size -= block.size;
+      blocks.pop_front();
+      block_offset = 0;
+      block_consumed.notify_one();
+    }
+  }
+  return true;
+}
+
+bool IPCSocketStreamReader::SkipPadding() {
+  idx_t padding_bytes = (8 - (stream_offset % 8)) % 8;
+  return Receive(nullptr, padding_bytes);
+}
+
+ArrowIpcMessageType IPCSocketStreamReader::ReadNextMessage() {
+  if (finished) {
+    return NANOARROW_IPC_MESSAGE_TYPE_UNINITIALIZED;
+  }
+  if (!SkipPadding() || !Receive(reinterpret_cast<data_ptr_t>(&message_prefix),
+                                 sizeof(message_prefix))) {
+    // The peer closed the connection without an end-of-stream marker
+    finished = true;
+    return NANOARROW_IPC_MESSAGE_TYPE_UNINITIALIZED;
+  }
+  if (message_prefix.continuation_token != kContinuationToken) {
+    throw IOException(std::string("Expected continuation token (0xFFFFFFFF) but got " +
+                                  std::to_string(message_prefix.continuation_token)));
+  }
+  return DecodeMessage();
+}
+
+data_ptr_t IPCSocketStreamReader::ReadData(data_ptr_t ptr, idx_t size) {
+  if (!Receive(ptr, size) && size > 0) {
+    throw IOException("Arrow IPC stream from \"%s\" ended in the middle of a message",
+                      address);
+  }
+  return ptr;
+}
+
+bool IPCSocketStreamReader::DecodeHeader(idx_t message_header_size) {
+  if (message_header.GetSize() < message_header_size) {
+    message_header = allocator.Allocate(message_header_size);
+  }
+  std::memcpy(message_header.get(), &message_prefix, sizeof(message_prefix));
+  ReadData(message_header.get() + sizeof(message_prefix), message_prefix.metadata_size);
+
+  header_view = AllocatedDataView(message_header.get(),
+                                  static_cast<int64_t>(message_header_size));
+  ArrowErrorCode decode_header_status =
+      ArrowIpcDecoderDecodeHeader(decoder.get(), header_view, &error);
+  if (decode_header_status == ENODATA) {
+    // End-of-stream marker: the rest of the connection is not read
+    finished = true;
+    return true;
+  }
+  THROW_NOT_OK(IOException, &error, decode_header_status);
+  return false;
+}
+
+void IPCSocketStreamReader::DecodeBody() {
+  message_body.reset();
+  cur_ptr = nullptr;
+  cur_size = 0;
+  if (decoder->body_size_bytes <= 0) {
+    return;
+  }
+  if (!SkipPadding()) {
+    throw IOException("Arrow IPC stream from \"%s\" ended in the middle of a message",
+                      address);
+  }
+  auto body_size = static_cast<idx_t>(decoder->body_size_bytes);
+  message_body = make_shared_ptr<AllocatedData>(allocator.Allocate(body_size));
+  ReadData(message_body->get(), body_size);
+  cur_ptr = message_body->get();
+  cur_size = decoder->body_size_bytes;
+}
+
+void IPCSocketStreamReader::SkipBody() {
+  message_body.reset();
+  if (decoder->body_size_bytes > 0) {
+    if (!SkipPadding()) {
+      throw IOException("Arrow IPC stream from \"%s\" ended in the middle of a message",
+                        address);
+    }
+    ReadData(nullptr, static_cast<idx_t>(decoder->body_size_bytes));
+  }
+}
+
+nanoarrow::UniqueBuffer IPCSocketStreamReader::GetUniqueBuffer() {
+  if (!message_body) {
+    return nanoarrow::UniqueBuffer();
+  }
+  return AllocatedDataToOwningBuffer(message_body);
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
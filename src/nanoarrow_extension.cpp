@@ -33,9 +33,11 @@ struct NanoarrowVersion {
 void LoadInternal(DatabaseInstance& db) {
   NanoarrowVersion::Register(db);
   ext_nanoarrow::RegisterReadArrowStream(db);
+  ext_nanoarrow::RegisterReadArrowSocket(db);
   ext_nanoarrow::RegisterArrowStreamCopyFunction(db);
 
   ext_nanoarrow::ScanArrowIPC::RegisterReadArrowStream(db);
+  ext_nanoarrow::RegisterFromArrowIPC(db);
   ext_nanoarrow::ToArrowIPCFunction::RegisterToIPCFunction(db);
 }
 
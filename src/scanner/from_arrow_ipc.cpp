@@ -0,0 +1,213 @@
+#include "table_function/scan_arrow_ipc.hpp"
+
+#include "duckdb/common/arrow/arrow_wrapper.hpp"
+#include "duckdb/function/table/arrow.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+#include "ipc/stream_reader/ipc_buffer_stream_reader.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+namespace {
+
+struct FromArrowIPCFunctionData : public TableFunctionData {
+  ArrowSchemaWrapper schema_root;
+  ArrowTableType arrow_table;
+};
+
+struct FromArrowIPCLocalState : public LocalTableFunctionState {
+  //! Decodes the messages of this thread, with the schema of the bind data
+  unique_ptr<IPCBufferStreamReader> reader;
+  //! The record batch being converted
+  unique_ptr<ArrowScanLocalState> scan_state;
+  //! Next row of the input chunk to decode
+  idx_t input_row = 0;
+  //! The message and header vectors of the input chunk, unified when its first
+  //! row is decoded
+  UnifiedVectorFormat messages;
+  UnifiedVectorFormat headers;
+  //! Copy of the current message if the input wasn't aligned
+  shared_ptr<AllocatedData> aligned_message;
+};
+
+//! A record batch decoded from a message of the input chunk. Its buffers point into
+//! the message, so it keeps the string buffers of the input vector alive.
+struct InputBatch {
+  ArrowArray batch;
+  buffer_ptr<VectorBuffer> input_buffer;
+  buffer_ptr<VectorBuffer> input_auxiliary;
+  shared_ptr<AllocatedData> aligned_message;
+};
+
+void ReleaseInputBatch(ArrowArray* array) {
+  auto input_batch = static_cast<InputBatch*>(array->private_data);
+  if (input_batch->batch.release) {
+    input_batch->batch.release(&input_batch->batch);
+  }
+  delete input_batch;
+  array->release = nullptr;
+}
+
+//! Moves a decoded record batch into out, which then owns the input it points into
+void WrapInputBatch(ArrowArray& batch, Vector& input,
+                    shared_ptr<AllocatedData> aligned_message, ArrowArray* out) {
+  auto input_batch = new InputBatch();
+  ArrowArrayMove(&batch, &input_batch->batch);
+  input_batch->input_buffer = input.GetBuffer();
+  input_batch->input_auxiliary = input.GetAuxiliary();
+  input_batch->aligned_message = std::move(aligned_message);
+
+  *out = input_batch->batch;
+  out->private_data = input_batch;
+  out->release = ReleaseInputBatch;
+}
+
+}  // namespace
+
+//! from_arrow_ipc((SELECT ipc, header FROM ...), schema) decodes the record batch
+//! messages of a table with the columns of to_arrow_ipc(). The output types are
+//! needed when binding, before the input is read, so the schema message is passed as
+//! a constant (e.g., with SET VARIABLE); the header rows of the input are skipped.
+//! Each thread decodes the messages of its input chunks in place.
+struct FromArrowIPCFunction : ArrowTableFunction {
+  static unique_ptr<FunctionData> Bind(ClientContext& context,
+                                       TableFunctionBindInput& input,
+                                       vector<LogicalType>& return_types,
+                                       vector<string>& names) {
+    auto& input_types = input.input_table_types;
+    if (input_types.size() != 2 || input_types[0].id() != LogicalTypeId::BLOB ||
+        input_types[1].id() != LogicalTypeId::BOOLEAN) {
+      throw BinderException(
+          "from_arrow_ipc expects a table of (ipc BLOB, header BOOLEAN), as returned "
+          "by to_arrow_ipc");
+    }
+    if (input.inputs[1].IsNull()) {
+      throw BinderException("from_arrow_ipc expects a schema message, not NULL");
+    }
+    auto& schema_message = StringValue::Get(input.inputs[1]);
+
+    auto result = make_uniq<FromArrowIPCFunctionData>();
+    vector<ArrowIPCBuffer> buffers;
+    buffers.emplace_back(reinterpret_cast<uintptr_t>(schema_message.data()),
+                         schema_message.size());
+    IPCBufferStreamReader schema_reader(std::move(buffers),
+                                        BufferAllocator::Get(context));
+    NANOARROW_THROW_NOT_OK(ArrowSchemaDeepCopy(schema_reader.GetBaseSchema(),
+                                               &result->schema_root.arrow_schema));
+
+    DBConfig& config = DatabaseInstance::GetDatabase(context).config;
+    PopulateArrowTableType(config, result->arrow_table, result->schema_root, names,
+                           return_types);
+    QueryResult::DeduplicateColumns(names);
+    if (return_types.empty()) {
+      throw InvalidInputException("The Arrow IPC schema must have at least one column");
+    }
+    return std::move(result);
+  }
+
+  static unique_ptr<LocalTableFunctionState> InitLocal(
+      ExecutionContext& context, TableFunctionInitInput& input,
+      GlobalTableFunctionState* global_state) {
+    auto& data = input.bind_data->Cast<FromArrowIPCFunctionData>();
+    auto result = make_uniq<FromArrowIPCLocalState>();
+    result->reader = make_uniq<IPCBufferStreamReader>(
+        vector<ArrowIPCBuffer>(), BufferAllocator::Get(context.client));
+    result->reader->SetBaseSchema(&data.schema_root.arrow_schema);
+    result->scan_state =
+        make_uniq<ArrowScanLocalState>(make_uniq<ArrowArrayWrapper>(), context.client);
+    return std::move(result);
+  }
+
+  //! Starts decoding the next data message of the input chunk, returns false if
+  //! there is none
+  static bool NextMessage(ClientContext& context, FromArrowIPCLocalState& state,
+                          DataChunk& input) {
+    auto& messages = state.messages;
+    auto& headers = state.headers;
+    if (state.input_row == 0) {
+      input.data[0].ToUnifiedFormat(input.size(), messages);
+      input.data[1].ToUnifiedFormat(input.size(), headers);
+    }
+    auto message_data = UnifiedVectorFormat::GetData<string_t>(messages);
+    auto header_data = UnifiedVectorFormat::GetData<bool>(headers);
+    while (state.input_row < input.size()) {
+      auto row = state.input_row++;
+      auto message_idx = messages.sel->get_index(row);
+      auto header_idx = headers.sel->get_index(row);
+      if (!messages.validity.RowIsValid(message_idx) ||
+          (headers.validity.RowIsValid(header_idx) && header_data[header_idx])) {
+        continue;
+      }
+      auto& message = message_data[message_idx];
+      auto ptr = const_data_ptr_cast(message.GetData());
+      auto size = message.GetSize();
+      state.aligned_message.reset();
+      if (reinterpret_cast<uintptr_t>(ptr) % 8 != 0) {
+        // The buffers of record batches must be aligned, blobs that were read from
+        // storage may not be
+        state.aligned_message = make_shared_ptr<AllocatedData>(
+            BufferAllocator::Get(context).Allocate(size));
+        memcpy(state.aligned_message->get(), ptr, size);
+        ptr = state.aligned_message->get();
+      }
+      vector<ArrowIPCBuffer> buffers;
+      buffers.emplace_back(reinterpret_cast<uintptr_t>(ptr), size);
+      state.reader->SetBuffers(std::move(buffers));
+      return true;
+    }
+    return false;
+  }
+
+  static OperatorResultType Function(ExecutionContext& context,
+                                     TableFunctionInput& data_p, DataChunk& input,
+                                     DataChunk& output) {
+    auto& data = data_p.bind_data->Cast<FromArrowIPCFunctionData>();
+    auto& state = data_p.local_state->Cast<FromArrowIPCLocalState>();
+    auto& scan_state = *state.scan_state;
+    while (true) {
+      if (scan_state.chunk && scan_state.chunk->arrow_array.release) {
+        auto length = static_cast<idx_t>(scan_state.chunk->arrow_array.length);
+        if (scan_state.chunk_offset < length) {
+          auto count =
+              MinValue<idx_t>(STANDARD_VECTOR_SIZE, length - scan_state.chunk_offset);
+          output.SetCardinality(count);
+          ArrowToDuckDB(scan_state, data.arrow_table.GetColumns(), output, 0);
+          scan_state.chunk_offset += count;
+          output.Verify();
+          return OperatorResultType::HAVE_MORE_OUTPUT;
+        }
+      }
+
+      ArrowArray batch;
+      if (state.reader->GetNextBatch(&batch)) {
+        auto next_chunk = make_shared_ptr<ArrowArrayWrapper>();
+        WrapInputBatch(batch, input.data[0], state.aligned_message,
+                       &next_chunk->arrow_array);
+        scan_state.chunk = std::move(next_chunk);
+        scan_state.Reset();
+        continue;
+      }
+      if (!NextMessage(context.client, state, input)) {
+        state.input_row = 0;
+        scan_state.chunk.reset();
+        return OperatorResultType::NEED_MORE_INPUT;
+      }
+    }
+  }
+
+  static TableFunction GetFunction() {
+    TableFunction fun("from_arrow_ipc", {LogicalType::TABLE, LogicalType::BLOB}, nullptr,
+                      Bind, nullptr, InitLocal);
+    fun.in_out_function = Function;
+    return fun;
+  }
+};
+
+void RegisterFromArrowIPC(DatabaseInstance& db) {
+  ExtensionUtil::RegisterFunction(db, FromArrowIPCFunction::GetFunction());
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -2,6 +2,8 @@
 
 #include <inttypes.h>
 
+#include "file_scanner/arrow_cardinality.hpp"
+#include "file_scanner/arrow_file_scan.hpp"
 #include "file_scanner/arrow_multi_file_info.hpp"
 #include "zstd.h"
 
@@ -11,15 +13,31 @@
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/database.hpp"
 #include "duckdb/main/extension_util.hpp"
+#include "duckdb/parser/parsed_data/sample_options.hpp"
 #include "duckdb/parser/expression/constant_expression.hpp"
 #include "duckdb/parser/expression/function_expression.hpp"
 #include "duckdb/parser/tableref/table_function_ref.hpp"
+#include "duckdb/optimizer/optimizer.hpp"
+#include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/planner/expression/bound_aggregate_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/operator/logical_aggregate.hpp"
+#include "duckdb/planner/operator/logical_dummy_scan.hpp"
+#include "duckdb/planner/operator/logical_filter.hpp"
+#include "duckdb/planner/operator/logical_limit.hpp"
+#include "duckdb/planner/operator/logical_order.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
+#include "duckdb/planner/operator/logical_top_n.hpp"
+#include "duckdb/storage/statistics/numeric_stats.hpp"
 
 #include "nanoarrow/nanoarrow.hpp"
 #include "nanoarrow/nanoarrow_ipc.hpp"
 
 #include "ipc/stream_factory.hpp"
 #include "ipc/stream_reader/base_stream_reader.hpp"
+#include "ipc/stream_reader/ipc_socket_stream_reader.hpp"
 #include "nanoarrow_errors.hpp"
 #include "table_function/arrow_ipc_function_data.hpp"
 
@@ -44,11 +62,89 @@ struct ReadArrowStream : ArrowTableFunction {
   static TableFunction Function() {
     MultiFileFunction<ArrowMultiFileInfo> read_arrow("read_arrow");
     read_arrow.projection_pushdown = true;
-    read_arrow.filter_pushdown = false;
+    // Filters are applied by the scan, which also uses them to skip record batches
+    // through the statistics written by COPY ... (BATCH_STATISTICS true)
+    read_arrow.filter_pushdown = true;
     read_arrow.filter_prune = false;
+    read_arrow.sampling_pushdown = true;
+    read_arrow.init_global = InitGlobal;
+    read_arrow.dynamic_to_string = DynamicToString;
+    read_arrow.bind_replace = BindReplace;
+    read_arrow.named_parameters["direct_io"] = LogicalType::BOOLEAN;
     return static_cast<TableFunction>(read_arrow);
   }
 
+  //! Sockets aren't files: read_arrow('unix://...') and read_arrow('tcp://...') are
+  //! scanned by read_arrow_socket() instead of the multi-file reader
+  static unique_ptr<TableRef> BindReplace(ClientContext& context,
+                                          TableFunctionBindInput& input) {
+    if (input.inputs.empty() || input.inputs[0].IsNull() ||
+        input.inputs[0].type().id() != LogicalTypeId::VARCHAR) {
+      return nullptr;
+    }
+    auto source = StringValue::Get(input.inputs[0]);
+    if (!IPCSocketStreamReader::IsSocketAddress(source)) {
+      return nullptr;
+    }
+    if (!input.named_parameters.empty()) {
+      throw BinderException("read_arrow doesn't support options for socket sources");
+    }
+    auto table_function = make_uniq<TableFunctionRef>();
+    vector<unique_ptr<ParsedExpression>> children;
+    children.push_back(make_uniq<ConstantExpression>(Value(source)));
+    table_function->function =
+        make_uniq<FunctionExpression>("read_arrow_socket", std::move(children));
+    return std::move(table_function);
+  }
+
+  static unique_ptr<GlobalTableFunctionState> InitGlobal(ClientContext& context,
+                                                         TableFunctionInitInput& input) {
+    auto result =
+        MultiFileFunction<ArrowMultiFileInfo>::MultiFileInitGlobal(context, input);
+    auto& gstate = result->Cast<MultiFileGlobalState>()
+                       .global_state->Cast<ArrowFileGlobalState>();
+
+    // A pushed down SYSTEM sample is applied per record batch: batches that are
+    // not part of the sample are skipped without reading their body.
+    if (input.sample_options) {
+      auto& sample_options = *input.sample_options;
+      if (sample_options.method != SampleMethod::SYSTEM_SAMPLE ||
+          !sample_options.is_percentage) {
+        throw InternalException("read_arrow only supports SYSTEM sampling pushdown");
+      }
+      gstate.sample_percentage = sample_options.sample_size.GetValue<double>();
+      gstate.sample_seed = sample_options.seed;
+    }
+    return result;
+  }
+
+  //! Adds the number of files that were opened in the background, the rows that
+  //! prefilters skipped and the record batches read in slices or served from a
+  //! cache to the profile
+  static InsertionOrderPreservingMap<string> DynamicToString(
+      TableFunctionDynamicToStringInput& input) {
+    auto result =
+        MultiFileFunction<ArrowMultiFileInfo>::MultiFileDynamicToString(input);
+    auto& multi_file_state = input.global_state->Cast<MultiFileGlobalState>();
+    if (multi_file_state.global_state) {
+      auto& gstate = multi_file_state.global_state->Cast<ArrowFileGlobalState>();
+      if (gstate.prefetcher) {
+        result["Prefetched Files"] =
+            std::to_string(gstate.prefetcher->PrefetchedFileCount());
+      }
+      if (gstate.prefiltered_rows > 0) {
+        result["Prefiltered Rows"] = std::to_string(gstate.prefiltered_rows.load());
+      }
+      if (gstate.sliced_batches > 0) {
+        result["Sliced Batches"] = std::to_string(gstate.sliced_batches.load());
+      }
+      if (gstate.cached_batches > 0) {
+        result["Cached Batches"] = std::to_string(gstate.cached_batches.load());
+      }
+    }
+    return result;
+  }
+
   static unique_ptr<TableRef> ScanReplacement(ClientContext& context,
                                               ReplacementScanInput& input,
                                               optional_ptr<ReplacementScanData> data) {
@@ -71,6 +167,345 @@ struct ReadArrowStream : ArrowTableFunction {
 
     return std::move(table_function);
   }
+
+  //! Finds LIMIT (+ OFFSET) operators that sit on top of a read_arrow() scan with
+  //! nothing but projections in between, and tells the scan how many rows the
+  //! query needs. The scan then stops reading (and opening files) early.
+  static void LimitPushdown(OptimizerExtensionInput& input,
+                            unique_ptr<LogicalOperator>& plan) {
+    for (auto& child : plan->children) {
+      LimitPushdown(input, child);
+    }
+    if (plan->type != LogicalOperatorType::LOGICAL_LIMIT) {
+      return;
+    }
+
+    auto& limit = plan->Cast<LogicalLimit>();
+    if (limit.limit_val.Type() != LimitNodeType::CONSTANT_VALUE) {
+      return;
+    }
+    idx_t row_count = limit.limit_val.GetConstantValue();
+    if (limit.offset_val.Type() == LimitNodeType::CONSTANT_VALUE) {
+      row_count += limit.offset_val.GetConstantValue();
+    } else if (limit.offset_val.Type() != LimitNodeType::UNSET) {
+      return;
+    }
+
+    reference<LogicalOperator> child = *limit.children[0];
+    while (child.get().type == LogicalOperatorType::LOGICAL_PROJECTION) {
+      child = *child.get().children[0];
+    }
+    if (child.get().type != LogicalOperatorType::LOGICAL_GET) {
+      return;
+    }
+    auto& get = child.get().Cast<LogicalGet>();
+    if (get.function.name != "read_arrow" || !get.bind_data ||
+        !get.table_filters.filters.empty()) {
+      return;
+    }
+
+    auto& bind_data = get.bind_data->Cast<MultiFileBindData>();
+    auto& arrow_data = bind_data.bind_data->Cast<ArrowMultiFileData>();
+    if (!arrow_data.limit.IsValid() || arrow_data.limit.GetIndex() > row_count) {
+      arrow_data.limit = row_count;
+    }
+  }
+
+  //! Returns the name of the read_arrow() column an expression refers to, following
+  //! it through projections and filters (which don't change the order of rows).
+  //! Returns nullptr if the expression isn't a plain column of a read_arrow() scan
+  //! whose file declares a sort order.
+  static optional_ptr<const ArrowMultiFileData> FindSortedColumn(
+      LogicalOperator& op, const Expression& expression, string& column_name) {
+    if (expression.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+      return nullptr;
+    }
+    auto binding = expression.Cast<BoundColumnRefExpression>().binding;
+    reference<LogicalOperator> child = op;
+    while (true) {
+      if (child.get().type == LogicalOperatorType::LOGICAL_PROJECTION) {
+        auto& projection = child.get().Cast<LogicalProjection>();
+        if (binding.table_index != projection.table_index ||
+            binding.column_index >= projection.expressions.size()) {
+          return nullptr;
+        }
+        auto& projected = *projection.expressions[binding.column_index];
+        if (projected.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+          return nullptr;
+        }
+        binding = projected.Cast<BoundColumnRefExpression>().binding;
+      } else if (child.get().type != LogicalOperatorType::LOGICAL_FILTER) {
+        break;
+      }
+      child = *child.get().children[0];
+    }
+
+    if (child.get().type != LogicalOperatorType::LOGICAL_GET) {
+      return nullptr;
+    }
+    auto& get = child.get().Cast<LogicalGet>();
+    if (get.function.name != "read_arrow" || !get.bind_data ||
+        binding.table_index != get.table_index) {
+      return nullptr;
+    }
+    auto& arrow_data =
+        get.bind_data->Cast<MultiFileBindData>().bind_data->Cast<ArrowMultiFileData>();
+    if (arrow_data.sort_order.empty()) {
+      return nullptr;
+    }
+
+    auto& column_ids = get.GetColumnIds();
+    if (binding.column_index >= column_ids.size()) {
+      return nullptr;
+    }
+    auto column_id = column_ids[binding.column_index].GetPrimaryIndex();
+    if (column_id >= get.names.size()) {
+      // e.g., the filename column
+      return nullptr;
+    }
+    column_name = get.names[column_id];
+    return &arrow_data;
+  }
+
+  //! Checks if the rows coming out of op are already in the requested order because
+  //! they come from a read_arrow() scan of a file that is sorted by (a superset of)
+  //! the ORDER BY keys
+  static bool IsSortedBy(LogicalOperator& op, const vector<BoundOrderByNode>& orders) {
+    optional_ptr<const ArrowMultiFileData> scan;
+    for (idx_t i = 0; i < orders.size(); i++) {
+      string column_name;
+      auto arrow_data = FindSortedColumn(op, *orders[i].expression, column_name);
+      if (!arrow_data || (scan && scan != arrow_data) ||
+          i >= arrow_data->sort_order.size()) {
+        return false;
+      }
+      scan = arrow_data;
+      auto& key = arrow_data->sort_order[i];
+      if (key.column != column_name || key.type != orders[i].type ||
+          key.null_order != orders[i].null_order) {
+        return false;
+      }
+    }
+    return scan != nullptr;
+  }
+
+  //! Removes ORDER BY operators (and turns Top-N into LIMIT) on top of a read_arrow()
+  //! scan of a file that declares it is sorted by the ORDER BY keys (only if
+  //! arrow_trust_sort_order is enabled). This relies on the scan producing rows in
+  //! file order, i.e., on insertion order being preserved.
+  static void SortElimination(OptimizerExtensionInput& input,
+                              unique_ptr<LogicalOperator>& plan) {
+    for (auto& child : plan->children) {
+      SortElimination(input, child);
+    }
+    if (!DBConfig::GetConfig(input.context).options.preserve_insertion_order) {
+      return;
+    }
+
+    if (plan->type == LogicalOperatorType::LOGICAL_ORDER_BY) {
+      auto& order = plan->Cast<LogicalOrder>();
+      // A projection map would hide columns of the child that we'd expose otherwise
+      if (order.projection_map.empty() && IsSortedBy(*order.children[0], order.orders)) {
+        plan = std::move(order.children[0]);
+      }
+    } else if (plan->type == LogicalOperatorType::LOGICAL_TOP_N) {
+      auto& top_n = plan->Cast<LogicalTopN>();
+      if (IsSortedBy(*top_n.children[0], top_n.orders)) {
+        auto limit = make_uniq<LogicalLimit>(
+            BoundLimitNode::ConstantValue(static_cast<int64_t>(top_n.limit)),
+            top_n.offset > 0
+                ? BoundLimitNode::ConstantValue(static_cast<int64_t>(top_n.offset))
+                : BoundLimitNode());
+        limit->children.push_back(std::move(top_n.children[0]));
+        plan = std::move(limit);
+      }
+    }
+  }
+
+  //! Returns the read_arrow() scan below an aggregate, looking through projections,
+  //! and the scan column each aggregated column binding refers to. Returns nullptr
+  //! if the scan can't answer the aggregates from statistics.
+  static optional_ptr<LogicalGet> FindStatisticsScan(LogicalOperator& op,
+                                                     vector<ColumnBinding>& bindings) {
+    reference<LogicalOperator> child = op;
+    while (child.get().type == LogicalOperatorType::LOGICAL_PROJECTION) {
+      auto& projection = child.get().Cast<LogicalProjection>();
+      for (auto& binding : bindings) {
+        if (binding.table_index != projection.table_index ||
+            binding.column_index >= projection.expressions.size()) {
+          return nullptr;
+        }
+        auto& projected = *projection.expressions[binding.column_index];
+        if (projected.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+          return nullptr;
+        }
+        binding = projected.Cast<BoundColumnRefExpression>().binding;
+      }
+      child = *child.get().children[0];
+    }
+    if (child.get().type != LogicalOperatorType::LOGICAL_GET) {
+      return nullptr;
+    }
+
+    auto& get = child.get().Cast<LogicalGet>();
+    if (get.function.name != "read_arrow" || !get.bind_data ||
+        !get.table_filters.filters.empty() || get.extra_info.sample_options) {
+      return nullptr;
+    }
+    auto& bind_data = get.bind_data->Cast<MultiFileBindData>();
+    if (bind_data.file_options.union_by_name || bind_data.file_options.hive_partitioning) {
+      return nullptr;
+    }
+    auto& column_ids = get.GetColumnIds();
+    for (auto& binding : bindings) {
+      if (binding.table_index != get.table_index ||
+          binding.column_index >= column_ids.size() ||
+          column_ids[binding.column_index].GetPrimaryIndex() >= get.names.size()) {
+        return nullptr;
+      }
+      // From here on, the binding refers to the column of the file
+      binding.column_index = column_ids[binding.column_index].GetPrimaryIndex();
+    }
+    return &get;
+  }
+
+  //! Computes the result of min(), max(), count() or count(*) from the statistics
+  //! of all files. Returns false if the statistics aren't exact enough for that.
+  static bool AggregateFromStatistics(const BoundAggregateExpression& aggregate,
+                                      idx_t row_count,
+                                      optional_ptr<BaseStatistics> stats, Value& result) {
+    auto& name = aggregate.function.name;
+    if (name == "count_star") {
+      result = Value::BIGINT(static_cast<int64_t>(row_count));
+      return true;
+    }
+    if (name == "count") {
+      // Null counts aren't tracked, so only columns without nulls are counted
+      if (stats->CanHaveNull()) {
+        return false;
+      }
+      result = Value::BIGINT(static_cast<int64_t>(row_count));
+      return true;
+    }
+    // String statistics only keep a prefix of min/max, numeric ones are exact
+    if (stats->GetStatsType() != StatisticsType::NUMERIC_STATS) {
+      return false;
+    }
+    if (!stats->CanHaveNoNull()) {
+      // No values at all (e.g., no rows)
+      result = Value(aggregate.return_type);
+      return true;
+    }
+    if (!NumericStats::HasMinMax(*stats)) {
+      return false;
+    }
+    auto value = name == "min" ? NumericStats::Min(*stats) : NumericStats::Max(*stats);
+    result = value.DefaultCastAs(aggregate.return_type);
+    return true;
+  }
+
+  //! Replaces ungrouped min(), max() and count() aggregates over a read_arrow() scan
+  //! by their result, computed from the batch statistics written by
+  //! COPY ... (BATCH_STATISTICS true). Only the schema and the statistics at the
+  //! end of each file are read, and they are cached across queries. Nothing changes
+  //! if one of the files has no statistics or there are too many files.
+  static void StatisticsAggregates(OptimizerExtensionInput& input,
+                                   unique_ptr<LogicalOperator>& plan) {
+    for (auto& child : plan->children) {
+      StatisticsAggregates(input, child);
+    }
+    if (plan->type != LogicalOperatorType::LOGICAL_AGGREGATE_AND_GROUP_BY) {
+      return;
+    }
+    auto& aggregate = plan->Cast<LogicalAggregate>();
+    if (!aggregate.groups.empty() || !aggregate.grouping_functions.empty() ||
+        aggregate.expressions.empty()) {
+      return;
+    }
+
+    // The scan column each aggregate refers to (if any)
+    vector<ColumnBinding> bindings;
+    vector<optional_idx> binding_indexes;
+    for (auto& expression : aggregate.expressions) {
+      if (expression->GetExpressionClass() != ExpressionClass::BOUND_AGGREGATE) {
+        return;
+      }
+      auto& aggr = expression->Cast<BoundAggregateExpression>();
+      auto& name = aggr.function.name;
+      if (aggr.filter || aggr.order_bys ||
+          (aggr.IsDistinct() && name != "min" && name != "max")) {
+        return;
+      }
+      if (name == "count_star" && aggr.children.empty()) {
+        binding_indexes.emplace_back();
+        continue;
+      }
+      if ((name != "min" && name != "max" && name != "count") ||
+          aggr.children.size() != 1 ||
+          aggr.children[0]->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+        return;
+      }
+      binding_indexes.emplace_back(bindings.size());
+      bindings.push_back(aggr.children[0]->Cast<BoundColumnRefExpression>().binding);
+    }
+    auto get = FindStatisticsScan(*aggregate.children[0], bindings);
+    if (!get) {
+      return;
+    }
+
+    auto& context = input.context;
+    auto& bind_data = get->bind_data->Cast<MultiFileBindData>();
+    auto file_count = bind_data.file_list->GetTotalFileCount();
+    if (file_count > ArrowCardinality::MAX_STATISTICS_FILES) {
+      return;
+    }
+    idx_t row_count = 0;
+    vector<unique_ptr<BaseStatistics>> column_stats(get->names.size());
+    for (idx_t i = 0; i < file_count; i++) {
+      auto file = bind_data.file_list->GetFile(i);
+      auto file_stats = ArrowCardinality::ReadColumnStatistics(context, file.path);
+      if (!file_stats || !file_stats->has_statistics || file_stats->names != get->names ||
+          file_stats->types != get->returned_types) {
+        return;
+      }
+      row_count += file_stats->row_count;
+      for (auto& binding : bindings) {
+        auto& column = *file_stats->columns[binding.column_index];
+        auto& stats = column_stats[binding.column_index];
+        if (!stats) {
+          stats = column.ToUnique();
+        } else {
+          stats->Merge(column);
+        }
+      }
+    }
+
+    vector<unique_ptr<Expression>> results;
+    for (idx_t i = 0; i < aggregate.expressions.size(); i++) {
+      auto& aggr = aggregate.expressions[i]->Cast<BoundAggregateExpression>();
+      optional_ptr<BaseStatistics> stats;
+      if (binding_indexes[i].IsValid()) {
+        stats = column_stats[bindings[binding_indexes[i].GetIndex()].column_index].get();
+        if (!stats) {
+          // No files at all
+          return;
+        }
+      }
+      Value result;
+      if (!AggregateFromStatistics(aggr, row_count, stats, result)) {
+        return;
+      }
+      results.push_back(make_uniq<BoundConstantExpression>(std::move(result)));
+    }
+
+    // The aggregate's output is a single row with the aggregates as columns of
+    // aggregate_index, which a projection of constants reproduces
+    auto projection =
+        make_uniq<LogicalProjection>(aggregate.aggregate_index, std::move(results));
+    projection->children.push_back(
+        make_uniq<LogicalDummyScan>(input.optimizer.binder.GenerateTableIndex()));
+    plan = std::move(projection);
+  }
 };
 
 TableFunction ReadArrowStreamFunction() { return ReadArrowStream::Function(); }
@@ -83,6 +518,49 @@ void RegisterReadArrowStream(DatabaseInstance& db) {
   ExtensionUtil::RegisterFunction(db, function);
   auto& config = DBConfig::GetConfig(db);
   config.replacement_scans.emplace_back(ReadArrowStream::ScanReplacement);
+
+  // Runs before the limit pushdown, which can then push the LIMITs that replace
+  // Top-N operators into the scan
+  OptimizerExtension sort_elimination;
+  sort_elimination.optimize_function = ReadArrowStream::SortElimination;
+  config.optimizer_extensions.push_back(std::move(sort_elimination));
+
+  OptimizerExtension statistics_aggregates;
+  statistics_aggregates.optimize_function = ReadArrowStream::StatisticsAggregates;
+  config.optimizer_extensions.push_back(std::move(statistics_aggregates));
+
+  OptimizerExtension limit_pushdown;
+  limit_pushdown.optimize_function = ReadArrowStream::LimitPushdown;
+  config.optimizer_extensions.push_back(std::move(limit_pushdown));
+
+  config.AddExtensionOption(
+      "arrow_batch_cache_size",
+      "Memory used to cache decoded record batches of read_arrow across queries (e.g., "
+      "'1GB'). The cache is disabled if this is 0.",
+      LogicalType::VARCHAR, Value("0"));
+  config.AddExtensionOption(
+      "arrow_shared_scan_window",
+      "Memory used by concurrent read_arrow scans of the same file to share the record "
+      "batches they decode (e.g., '128MB'), in total over all files that are scanned "
+      "concurrently. Scans are not shared if this is 0.",
+      LogicalType::VARCHAR, Value("128MB"));
+  config.AddExtensionOption(
+      "arrow_prefetch_files",
+      "Number of files that multi-file read_arrow scans open and start reading in the "
+      "background before they are scanned. Files are not prefetched if this is 0.",
+      LogicalType::UBIGINT, Value::UBIGINT(2));
+  config.AddExtensionOption(
+      "arrow_sliced_batch_size",
+      "Uncompressed record batches of at least this size (e.g., '64MB') are read by "
+      "read_arrow in slices of rows instead of as a whole. Batches are always read "
+      "as a whole if this is 0.",
+      LogicalType::VARCHAR, Value("64MB"));
+  config.AddExtensionOption(
+      "arrow_trust_sort_order",
+      "Whether read_arrow skips ORDER BYs that the duckdb:sort_order key of a file's "
+      "schema declares satisfied. The order is not verified, so a wrong key gives "
+      "wrongly ordered results.",
+      LogicalType::BOOLEAN, Value::BOOLEAN(false));
 }
 
 }  // namespace ext_nanoarrow
@@ -0,0 +1,65 @@
+#include "table_function/read_arrow.hpp"
+
+#include "duckdb/function/table/arrow.hpp"
+#include "duckdb/main/config.hpp"
+#include "duckdb/main/extension_util.hpp"
+
+#include "ipc/stream_factory.hpp"
+#include "ipc/stream_reader/ipc_socket_stream_reader.hpp"
+#include "table_function/arrow_ipc_function_data.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+//! Scans an IPC stream received from a socket (read_arrow('unix://...') and
+//! read_arrow('tcp://host:port') are replaced by it). The schema is received when
+//! binding, the record batches as the scan consumes them.
+struct ReadArrowSocketFunction : ArrowTableFunction {
+  static unique_ptr<FunctionData> Bind(ClientContext& context,
+                                       TableFunctionBindInput& input,
+                                       vector<LogicalType>& return_types,
+                                       vector<string>& names) {
+    auto address = input.inputs[0].ToString();
+    if (!IPCSocketStreamReader::IsSocketAddress(address)) {
+      throw InvalidInputException(
+          "read_arrow_socket expects a unix://path or tcp://host:port address");
+    }
+    // read_arrow() of a socket address is bound here as well
+    if (!DBConfig::GetConfig(context).options.enable_external_access) {
+      throw PermissionException(
+          "Reading Arrow IPC streams from sockets is disabled through configuration");
+    }
+    auto stream_factory = make_uniq<SocketIPCStreamFactory>(context, address);
+    auto res = make_uniq<ArrowIPCFunctionData>(std::move(stream_factory));
+    res->factory->InitReader();
+    res->factory->GetFileSchema(res->schema_root);
+
+    DBConfig& config = DatabaseInstance::GetDatabase(context).config;
+    PopulateArrowTableType(config, res->arrow_table, res->schema_root, names,
+                           return_types);
+    QueryResult::DeduplicateColumns(names);
+    res->all_types = return_types;
+    if (return_types.empty()) {
+      throw InvalidInputException(
+          "Provided table/dataframe must have at least one column");
+    }
+    return std::move(res);
+  }
+
+  static TableFunction Function() {
+    TableFunction read_arrow_socket("read_arrow_socket", {LogicalType::VARCHAR},
+                                    ArrowScanFunction, Bind, ArrowScanInitGlobal,
+                                    ArrowScanInitLocal);
+    read_arrow_socket.projection_pushdown = true;
+    read_arrow_socket.filter_pushdown = false;
+    read_arrow_socket.filter_prune = false;
+    return read_arrow_socket;
+  }
+};
+
+void RegisterReadArrowSocket(DatabaseInstance& db) {
+  ExtensionUtil::RegisterFunction(db, ReadArrowSocketFunction::Function());
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -1,6 +1,7 @@
 
 #include "table_function/scan_arrow_ipc.hpp"
 #include "duckdb/main/extension_util.hpp"
+#include "ipc/shared_memory.hpp"
 #include "ipc/stream_factory.hpp"
 #include "table_function/arrow_ipc_function_data.hpp"
 
@@ -30,6 +31,31 @@ struct ScanArrowIPCFunction : ArrowTableFunction {
     }
 
     auto stream_factory = make_uniq<BufferIPCStreamFactory>(context, buffers);
+    return BindFactory(context, std::move(stream_factory), return_types, names);
+  }
+
+  //! scan_arrow_ipc('name') scans the POSIX shared memory object with this name
+  static unique_ptr<FunctionData> ScanSharedMemoryBind(ClientContext& context,
+                                                       TableFunctionBindInput& input,
+                                                       vector<LogicalType>& return_types,
+                                                       vector<string>& names) {
+    if (input.inputs[0].IsNull()) {
+      throw BinderException("scan_arrow_ipc expects a shared memory name, not NULL");
+    }
+    if (!DBConfig::GetConfig(context).options.enable_external_access) {
+      throw PermissionException(
+          "Scanning Arrow IPC streams in shared memory is disabled through "
+          "configuration");
+    }
+    auto mapping = SharedMemoryMapping::OpenName(input.inputs[0].ToString());
+    auto stream_factory =
+        make_uniq<SharedMemoryIPCStreamFactory>(context, std::move(mapping));
+    return BindFactory(context, std::move(stream_factory), return_types, names);
+  }
+
+  static unique_ptr<FunctionData> BindFactory(
+      ClientContext& context, unique_ptr<ArrowIPCStreamFactory> stream_factory,
+      vector<LogicalType>& return_types, vector<string>& names) {
     auto res = make_uniq<ArrowIPCFunctionData>(std::move(stream_factory));
     res->factory->InitReader();
     res->factory->GetFileSchema(res->schema_root);
@@ -47,13 +73,9 @@ struct ScanArrowIPCFunction : ArrowTableFunction {
     return std::move(res);
   }
 
-  static TableFunction Function() {
-    child_list_t<LogicalType> make_buffer_struct_children{{"ptr", LogicalType::POINTER},
-                                                          {"size", LogicalType::UBIGINT}};
-    TableFunction scan_arrow_ipc_func(
-        "scan_arrow_ipc",
-        {LogicalType::LIST(LogicalType::STRUCT(make_buffer_struct_children))},
-        ArrowScanFunction, ScanArrowIPCBind, ArrowScanInitGlobal, ArrowScanInitLocal);
+  static TableFunction Function(const LogicalType& argument, table_function_bind_t bind) {
+    TableFunction scan_arrow_ipc_func("scan_arrow_ipc", {argument}, ArrowScanFunction,
+                                      bind, ArrowScanInitGlobal, ArrowScanInitLocal);
 
     scan_arrow_ipc_func.cardinality = ArrowScanCardinality;
     scan_arrow_ipc_func.projection_pushdown = true;
@@ -62,11 +84,21 @@ struct ScanArrowIPCFunction : ArrowTableFunction {
 
     return scan_arrow_ipc_func;
   }
+
+  static TableFunctionSet FunctionSet() {
+    child_list_t<LogicalType> make_buffer_struct_children{{"ptr", LogicalType::POINTER},
+                                                          {"size", LogicalType::UBIGINT}};
+    TableFunctionSet scan_arrow_ipc("scan_arrow_ipc");
+    scan_arrow_ipc.AddFunction(
+        Function(LogicalType::LIST(LogicalType::STRUCT(make_buffer_struct_children)),
+                 ScanArrowIPCBind));
+    scan_arrow_ipc.AddFunction(Function(LogicalType::VARCHAR, ScanSharedMemoryBind));
+    return scan_arrow_ipc;
+  }
 };
 
 void ScanArrowIPC::RegisterReadArrowStream(DatabaseInstance& db) {
-  auto function = ScanArrowIPCFunction::Function();
-  ExtensionUtil::RegisterFunction(db, function);
+  ExtensionUtil::RegisterFunction(db, ScanArrowIPCFunction::FunctionSet());
 }
 
 }  // namespace ext_nanoarrow
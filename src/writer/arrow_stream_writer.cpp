@@ -7,14 +7,22 @@ ArrowStreamWriter::ArrowStreamWriter(ClientContext& context, FileSystem& fs,
                                      const string& file_path,
                                      const vector<LogicalType>& logical_types,
                                      const vector<string>& column_names,
-                                     const vector<pair<string, string>>& metadata)
+                                     const vector<pair<string, string>>& metadata,
+                                     bool direct_io, bool batch_statistics,
+                                     vector<idx_t> bloom_filter_columns_p)
     : options(context.GetClientProperties()),
       allocator(BufferAllocator::Get(context)),
       serializer(options, allocator),
       file_name(file_path),
-      logical_types(logical_types) {
+      logical_types(logical_types),
+      bloom_filter_columns(std::move(bloom_filter_columns_p)) {
   InitSchema(logical_types, column_names, metadata);
-  InitOutputFile(fs, file_path);
+  InitOutputFile(fs, file_path, direct_io);
+  if (batch_statistics || !bloom_filter_columns.empty()) {
+    statistics = make_uniq<ArrowFileStatistics>();
+    statistics->types = logical_types;
+    serializer.CollectStatistics(bloom_filter_columns);
+  }
 }
 
 void ArrowStreamWriter::InitSchema(const vector<LogicalType>& logical_types,
@@ -46,44 +54,83 @@ void ArrowStreamWriter::InitSchema(const vector<LogicalType>& logical_types,
   serializer.Init(schema.get(), logical_types);
 }
 
-void ArrowStreamWriter::InitOutputFile(FileSystem& fs, const string& file_path) {
+void ArrowStreamWriter::InitOutputFile(FileSystem& fs, const string& file_path,
+                                       bool direct_io) {
+  if (direct_io) {
+    direct_writer = make_uniq<DirectFileWriter>(fs, file_path, allocator);
+    return;
+  }
   writer = make_uniq<BufferedFileWriter>(
       fs, file_path.c_str(),
       FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
 }
 
+WriteStream& ArrowStreamWriter::Output() const {
+  if (direct_writer) {
+    return *direct_writer;
+  }
+  return *writer;
+}
+
 void ArrowStreamWriter::WriteSchema() {
   serializer.SerializeSchema();
-  serializer.Flush(*writer);
+  serializer.Flush(Output());
 }
 
 unique_ptr<ColumnDataCollectionSerializer> ArrowStreamWriter::NewSerializer() {
   auto serializer = make_uniq<ColumnDataCollectionSerializer>(options, allocator);
   serializer->Init(schema.get(), logical_types);
+  if (statistics) {
+    serializer->CollectStatistics(bloom_filter_columns);
+  }
   return serializer;
 }
 
+void ArrowStreamWriter::AddBatchStatistics(ColumnDataCollectionSerializer& serializer) {
+  auto batch_statistics = serializer.GetStatistics();
+  if (!statistics || !batch_statistics) {
+    return;
+  }
+  // The reader finds the statistics of a record batch by the offset of its message
+  batch_statistics->message_offset = FileSize();
+  statistics->batches.push_back(std::move(*batch_statistics));
+}
+
 void ArrowStreamWriter::Flush(ColumnDataCollection& buffer) {
   serializer.Serialize(buffer);
   buffer.Reset();
-  serializer.Flush(*writer);
+  AddBatchStatistics(serializer);
+  serializer.Flush(Output());
   ++row_group_count;
 }
 
 void ArrowStreamWriter::Flush(ColumnDataCollectionSerializer& serializer) {
-  serializer.Flush(*writer);
+  AddBatchStatistics(serializer);
+  serializer.Flush(Output());
   ++row_group_count;
 }
 
 void ArrowStreamWriter::Finalize() const {
   uint8_t end_of_stream[] = {0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00};
-  writer->WriteData(end_of_stream, sizeof(end_of_stream));
-  writer->Close();
+  Output().WriteData(end_of_stream, sizeof(end_of_stream));
+  if (statistics) {
+    statistics->Write(Output());
+  }
+  if (direct_writer) {
+    direct_writer->Close();
+  } else {
+    writer->Close();
+  }
 }
 
 idx_t ArrowStreamWriter::NumberOfRowGroups() const { return row_group_count; }
 
-idx_t ArrowStreamWriter::FileSize() const { return writer->GetTotalWritten(); }
+idx_t ArrowStreamWriter::FileSize() const {
+  if (direct_writer) {
+    return direct_writer->GetTotalWritten();
+  }
+  return writer->GetTotalWritten();
+}
 
 }  // namespace ext_nanoarrow
 }  // namespace duckdb
@@ -49,6 +49,7 @@ void ColumnDataCollectionSerializer::Init(const ArrowSchema* schema_p,
                ArrowArrayViewInitFromSchema(chunk_view.get(), schema_p, &error));
 
   schema = schema_p;
+  this->logical_types = logical_types;
 
   extension_types =
       ArrowTypeExtensionData::GetExtensionTypes(*options.client_context, logical_types);
@@ -57,6 +58,7 @@ void ColumnDataCollectionSerializer::Init(const ArrowSchema* schema_p,
 void ColumnDataCollectionSerializer::SerializeSchema() {
   header->size_bytes = 0;
   body->size_bytes = 0;
+  has_statistics = false;
   THROW_NOT_OK(InternalException, &error,
                ArrowIpcEncoderEncodeSchema(encoder.get(), schema, &error));
   NANOARROW_THROW_NOT_OK(
@@ -66,6 +68,7 @@ void ColumnDataCollectionSerializer::SerializeSchema() {
 idx_t ColumnDataCollectionSerializer::Serialize(ArrowArray& array) {
   header->size_bytes = 0;
   body->size_bytes = 0;
+  has_statistics = false;
 
   THROW_NOT_OK(duckdb::InternalException, &error,
                ArrowArrayViewSetArray(chunk_view.get(), &array, &error));
@@ -81,6 +84,15 @@ idx_t ColumnDataCollectionSerializer::Serialize(DataChunk& chunk) {
   header->size_bytes = 0;
   body->size_bytes = 0;
   chunk_arrow.reset();
+  has_statistics = false;
+  if (collect_statistics) {
+    statistics = ArrowBatchStatistics::Create(logical_types);
+    statistics.Update(chunk);
+    for (auto column_idx : bloom_filter_columns) {
+      statistics.AddBloomFilter(column_idx, chunk.data[column_idx], chunk.size());
+    }
+    has_statistics = true;
+  }
 
   ArrowConverter::ToArrowArray(chunk, chunk_arrow.get(), options, extension_types);
   THROW_NOT_OK(duckdb::InternalException, &error,
@@ -97,6 +109,7 @@ idx_t ColumnDataCollectionSerializer::Serialize(DataChunk& chunk) {
 idx_t ColumnDataCollectionSerializer::Serialize(const ColumnDataCollection& buffer) {
   header->size_bytes = 0;
   body->size_bytes = 0;
+  has_statistics = false;
   if (buffer.Count() == 0) {
     return 0;
   }
@@ -114,7 +127,7 @@ idx_t ColumnDataCollectionSerializer::Serialize(const ColumnDataCollection& buff
   return Serialize(chunk);
 }
 
-void ColumnDataCollectionSerializer::Flush(BufferedFileWriter& writer) {
+void ColumnDataCollectionSerializer::Flush(WriteStream& writer) {
   writer.WriteData(header->data, header->size_bytes);
   writer.WriteData(body->data, body->size_bytes);
 }
@@ -0,0 +1,58 @@
+#include "writer/direct_file_writer.hpp"
+
+namespace duckdb {
+namespace ext_nanoarrow {
+
+DirectFileWriter::DirectFileWriter(FileSystem& fs, const string& path,
+                                   Allocator& allocator)
+    : allocation(allocator.Allocate(BUFFER_SIZE + BLOCK_SIZE)) {
+  handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_WRITE |
+                                 FileFlags::FILE_FLAGS_FILE_CREATE_NEW |
+                                 FileFlags::FILE_FLAGS_DIRECT_IO);
+  // O_DIRECT requires the memory we write from to be block aligned
+  auto address = reinterpret_cast<uintptr_t>(allocation.get());
+  buffer = reinterpret_cast<data_ptr_t>(AlignValue<uintptr_t, BLOCK_SIZE>(address));
+}
+
+void DirectFileWriter::WriteData(const_data_ptr_t data, idx_t write_size) {
+  total_written += write_size;
+  while (write_size > 0) {
+    idx_t to_copy = MinValue<idx_t>(write_size, BUFFER_SIZE - buffer_offset);
+    std::memcpy(buffer + buffer_offset, data, to_copy);
+    buffer_offset += to_copy;
+    data += to_copy;
+    write_size -= to_copy;
+    if (buffer_offset == BUFFER_SIZE) {
+      FlushBuffer(BUFFER_SIZE);
+      buffer_offset = 0;
+    }
+  }
+}
+
+void DirectFileWriter::FlushBuffer(idx_t size) {
+  D_ASSERT(size % BLOCK_SIZE == 0);
+  handle->Write(buffer, size, file_offset);
+  file_offset += size;
+}
+
+void DirectFileWriter::Close() {
+  if (!handle) {
+    return;
+  }
+
+  if (buffer_offset > 0) {
+    // Pad the tail to a whole block and cut the padding off again afterwards
+    idx_t padded_size = AlignValue<idx_t, BLOCK_SIZE>(buffer_offset);
+    std::memset(buffer + buffer_offset, 0, padded_size - buffer_offset);
+    FlushBuffer(padded_size);
+    buffer_offset = 0;
+    handle->Truncate(static_cast<int64_t>(total_written));
+  }
+
+  handle->Sync();
+  handle->Close();
+  handle.reset();
+}
+
+}  // namespace ext_nanoarrow
+}  // namespace duckdb
@@ -1,6 +1,8 @@
 
 #include "write_arrow_stream.hpp"
 
+#include <algorithm>
+
 #include "duckdb/common/multi_file/multi_file_function.hpp"
 #include "file_scanner/arrow_multi_file_info.hpp"
 
@@ -11,6 +13,8 @@
 
 #include "nanoarrow/nanoarrow_ipc.hpp"
 
+#include "ipc/bloom_filter.hpp"
+#include "ipc/sort_order.hpp"
 #include "nanoarrow_errors.hpp"
 #include "table_function/read_arrow.hpp"
 #include "writer/arrow_stream_writer.hpp"
@@ -35,6 +39,12 @@ struct ArrowWriteBindData : public TableFunctionData {
   optional_idx row_groups_per_file;
   static constexpr const idx_t BYTES_PER_ROW = 1024;
   idx_t row_group_size_bytes{};
+  //! Write the file with O_DIRECT, bypassing the page cache
+  bool direct_io = false;
+  //! Append the min/max statistics of each record batch to the file
+  bool batch_statistics = false;
+  //! Columns whose values are added to a bloom filter per record batch
+  vector<idx_t> bloom_filter_columns;
 };
 
 struct ArrowWriteGlobalState : public GlobalFunctionData {
@@ -82,8 +92,62 @@ unique_ptr<FunctionData> ArrowWriteBind(ClientContext& context,
         bind_data->row_group_size_bytes = option.second[0].GetValue<uint64_t>();
       }
       row_group_size_bytes_set = true;
+    } else if (loption == "direct_io") {
+      bind_data->direct_io = option.second[0].GetValue<bool>();
+    } else if (loption == "batch_statistics") {
+      bind_data->batch_statistics = option.second[0].GetValue<bool>();
+    } else if (loption == "bloom_filter_columns") {
+      // A list of column names, or a string of comma separated column names
+      vector<string> columns;
+      auto& value = option.second[0];
+      if (value.type().id() == LogicalTypeId::LIST) {
+        for (const auto& child : ListValue::GetChildren(value)) {
+          columns.push_back(child.ToString());
+        }
+      } else {
+        for (const auto& column : StringUtil::Split(value.ToString(), ',')) {
+          columns.push_back(StringUtil::Strip(column));
+        }
+      }
+      for (const auto& column : columns) {
+        auto name = std::find_if(names.begin(), names.end(), [&](const string& name) {
+          return StringUtil::CIEquals(name, column);
+        });
+        if (name == names.end()) {
+          throw BinderException(
+              "BLOOM_FILTER_COLUMNS column \"%s\" is not written to the file", column);
+        }
+        auto column_idx = static_cast<idx_t>(name - names.begin());
+        if (!ArrowBloomFilter::SupportsType(sql_types[column_idx])) {
+          throw BinderException(
+              "BLOOM_FILTER_COLUMNS does not support column \"%s\" of type %s", *name,
+              sql_types[column_idx].ToString());
+        }
+        bind_data->bloom_filter_columns.push_back(column_idx);
+      }
     } else if (loption == "row_groups_per_file") {
       bind_data->row_groups_per_file = option.second[0].GetValue<uint64_t>();
+    } else if (loption == "sort_order") {
+      // Declares the order of the rows (which the query has to produce, e.g., with
+      // ORDER BY) so that read_arrow can skip sorting by it again
+      auto sort_keys = ArrowSortOrder::Parse(option.second[0].ToString());
+      for (auto& key : sort_keys) {
+        auto name = std::find_if(names.begin(), names.end(), [&](const string& name) {
+          return StringUtil::CIEquals(name, key.column);
+        });
+        if (name == names.end()) {
+          throw BinderException("SORT_ORDER column \"%s\" is not written to the file",
+                                key.column);
+        }
+        key.column = *name;
+      }
+      if (!DBConfig::GetConfig(context).options.preserve_insertion_order) {
+        throw BinderException(
+            "SORT_ORDER requires preserving insertion order, rows would otherwise be "
+            "written in any order");
+      }
+      bind_data->kv_metadata.emplace_back(ArrowSortOrder::METADATA_KEY,
+                                          ArrowSortOrder::ToString(sort_keys));
     } else if (loption == "kv_metadata") {
       auto& kv_struct = option.second[0];
       auto& kv_struct_type = kv_struct.type();
@@ -133,7 +197,9 @@ unique_ptr<GlobalFunctionData> ArrowWriteInitializeGlobal(ClientContext& context
   auto& fs = FileSystem::GetFileSystem(context);
   global_state->writer =
       make_uniq<ArrowStreamWriter>(context, fs, file_path, arrow_bind.sql_types,
-                                   arrow_bind.column_names, arrow_bind.kv_metadata);
+                                   arrow_bind.column_names, arrow_bind.kv_metadata,
+                                   arrow_bind.direct_io, arrow_bind.batch_statistics,
+                                   arrow_bind.bloom_filter_columns);
   global_state->writer->WriteSchema();
   return std::move(global_state);
 }
@@ -42,6 +42,26 @@ class TestArrowIPCBufferRead(object):
          msg_reader = ipc.MessageReader.open_stream(buf_reader)
          tables_match(connection.from_arrow(msg_reader).fetchall())
 
+   def test_string_view(self, connection):
+      # The variadic buffers of Utf8View columns are slices of the message body
+      long_strings = ['a string that is too long to be inlined ' + str(i) for i in range(1000)]
+      batch = pa.record_batch([
+            pa.array(range(1000)),
+            pa.array(['short' + str(i % 10) for i in range(1000)], pa.string_view()),
+            pa.array(long_strings, pa.string_view())
+         ], names=['i', 'short_str', 'long_str'])
+      sink = pa.BufferOutputStream()
+      with pa.ipc.new_stream(sink, batch.schema) as writer:
+         for _ in range(3):
+            writer.write_batch(batch)
+      buffer = sink.getvalue()
+
+      with pa.BufferReader(buffer) as buf_reader:
+         msg_reader = ipc.MessageReader.open_stream(buf_reader)
+         result = connection.from_arrow(msg_reader).fetchall()
+      expected = [(i, 'short' + str(i % 10), long_strings[i]) for i in range(1000)]
+      assert result == expected * 3
+
    def test_replacement_scan(self, connection):
 
       batch = get_record_batch()
@@ -57,3 +77,42 @@ class TestArrowIPCBufferRead(object):
          with pytest.raises(duckdb.InvalidInputException,
                  match="not suitable for replacement scans",):
             connection.execute("FROM msg_reader")
+
+
+def get_stream_bytes():
+   batch = get_record_batch()
+   sink = pa.BufferOutputStream()
+   with pa.ipc.new_stream(sink, batch.schema) as writer:
+      for _ in range(5):
+         writer.write_batch(batch)
+   return sink.getvalue().to_pybytes()
+
+
+class TestArrowIPCSharedMemoryRead(object):
+   def test_shared_memory(self, connection):
+      from multiprocessing import shared_memory
+      data = get_stream_bytes()
+      shm = shared_memory.SharedMemory(create=True, size=len(data))
+      try:
+         shm.buf[:len(data)] = data
+         tables_match(connection.execute("FROM scan_arrow_ipc(?)", [shm.name]).fetchall())
+         assert connection.execute("SELECT sum(f0) FROM scan_arrow_ipc(?)", [shm.name]).fetchall() == [(50,)]
+      finally:
+         shm.close()
+         shm.unlink()
+
+   def test_truncated(self, connection):
+      from multiprocessing import shared_memory
+      data = get_stream_bytes()[:-100]
+      shm = shared_memory.SharedMemory(create=True, size=len(data))
+      try:
+         shm.buf[:len(data)] = data
+         with pytest.raises(duckdb.IOException, match="ends in the middle of a message"):
+            connection.execute("FROM scan_arrow_ipc(?)", [shm.name]).fetchall()
+      finally:
+         shm.close()
+         shm.unlink()
+
+   def test_missing(self, connection):
+      with pytest.raises(duckdb.IOException, match="Could not open shared memory"):
+         connection.execute("FROM scan_arrow_ipc('nanoarrow_does_not_exist')")
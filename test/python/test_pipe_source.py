@@ -0,0 +1,46 @@
+import os
+import tempfile
+import threading
+
+import pyarrow as pa
+import pyarrow.ipc as ipc
+
+
+def get_table():
+    # Larger than the read-ahead window, so that it is refilled from the pipe
+    return pa.table({
+        'i': pa.array(range(2000000), type=pa.int64()),
+        's': pa.array([str(i) if i % 3 else None for i in range(2000000)]),
+    })
+
+
+def write_to_pipe(path, table, new_writer):
+    # Opening a pipe for writing blocks until the scan opens it for reading
+    with open(path, 'wb') as sink:
+        with new_writer(sink, table.schema) as writer:
+            for batch in table.to_batches(max_chunksize=10000):
+                writer.write_batch(batch)
+
+
+def read_from_pipe(connection, table, new_writer):
+    with tempfile.TemporaryDirectory() as temp_dir:
+        path = os.path.join(temp_dir, 'arrow.pipe')
+        os.mkfifo(path)
+        writer = threading.Thread(target=write_to_pipe, args=(path, table, new_writer))
+        writer.start()
+        try:
+            return connection.execute(
+                f"SELECT count(*), sum(i), count(s) FROM read_arrow('{path}')").fetchall()
+        finally:
+            writer.join()
+
+
+class TestPipeSource(object):
+    def test_stream(self, connection):
+        result = read_from_pipe(connection, get_table(), ipc.new_stream)
+        assert result == [(2000000, 1999999000000, 1333333)]
+
+    def test_file(self, connection):
+        # Without seeking to the footer, the stream inside the file is read
+        result = read_from_pipe(connection, get_table(), ipc.new_file)
+        assert result == [(2000000, 1999999000000, 1333333)]
@@ -0,0 +1,67 @@
+import os
+import socket
+import tempfile
+import threading
+
+import pyarrow as pa
+import pyarrow.ipc as ipc
+
+
+def get_table():
+    return pa.table({
+        'i': pa.array(range(100000), type=pa.int64()),
+        's': pa.array([str(i) if i % 3 else None for i in range(100000)]),
+    })
+
+
+def serve_stream(server, table, batch_size):
+    # Sends the table to the first peer that connects, then closes the connection
+    connection, _ = server.accept()
+    with connection, connection.makefile('wb') as sink:
+        with ipc.new_stream(sink, table.schema) as writer:
+            for batch in table.to_batches(max_chunksize=batch_size):
+                writer.write_batch(batch)
+    server.close()
+
+
+def start_peer(server, table, batch_size=1000):
+    server.listen(1)
+    peer = threading.Thread(target=serve_stream, args=(server, table, batch_size))
+    peer.start()
+    return peer
+
+
+class TestSocketSource(object):
+    def test_unix_socket(self, connection):
+        table = get_table()
+        with tempfile.TemporaryDirectory() as temp_dir:
+            path = os.path.join(temp_dir, 'arrow.sock')
+            server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            server.bind(path)
+            peer = start_peer(server, table)
+            result = connection.execute(
+                f"SELECT count(*), sum(i), count(s) FROM read_arrow('unix://{path}')").fetchall()
+            peer.join()
+        assert result == [(100000, 4999950000, 66666)]
+
+    def test_tcp_socket(self, connection):
+        table = get_table()
+        server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        server.bind(('127.0.0.1', 0))
+        port = server.getsockname()[1]
+        peer = start_peer(server, table, batch_size=7)
+        result = connection.execute(
+            f"FROM read_arrow('tcp://127.0.0.1:{port}')").arrow()
+        peer.join()
+        assert result.equals(table)
+
+    def test_connection_refused(self, connection):
+        server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        server.bind(('127.0.0.1', 0))
+        port = server.getsockname()[1]
+        server.close()
+        try:
+            connection.execute(f"FROM read_arrow('tcp://127.0.0.1:{port}')")
+            assert False
+        except Exception as ex:
+            assert 'Could not connect' in str(ex)